@@ -0,0 +1,87 @@
+/*
+ * File: aggregate.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Collects result lines that one or more multi-lookup processes
+ *      publish on a shared memory queue (multi-lookup -Q) and writes
+ *      them to a single output file. With -n it exits once that many
+ *      producers have finished, otherwise as soon as no producer is
+ *      attached after the first has finished.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "shmqueue.h"
+
+#define MINARGS 2
+#define USAGE "[-n producers] <queueName> <outputFilePath> [queueSize]"
+
+int main(int argc, char* argv[]){
+
+    /* Local Vars */
+    shmqueue q;
+    FILE* outputfp = NULL;
+    char line[SHMQUEUE_SLOTSIZE];
+    int size = QUEUEMAXSIZE;
+    int producers = 0;
+    const char* queueName;
+    int opt;
+
+    /* Check Arguments */
+    while((opt = getopt(argc, argv, "n:")) != -1){
+	switch(opt){
+	case 'n':
+	    producers = atoi(optarg);
+	    if(producers < 1){
+		fprintf(stderr, "Bad producer count: %s\n", optarg);
+		return EXIT_FAILURE;
+	    }
+	    break;
+	default:
+	    fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	    return EXIT_FAILURE;
+	}
+    }
+    if(argc - optind < MINARGS){
+	fprintf(stderr, "Not enough arguments: %d\n", (argc - optind));
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	return EXIT_FAILURE;
+    }
+    queueName = argv[optind];
+    if(argc - optind > MINARGS){
+	size = atoi(argv[optind + 2]);
+    }
+
+    /* Open Output File */
+    outputfp = fopen(argv[optind + 1], "w");
+    if(!outputfp){
+	perror("Error Opening Output File");
+	return EXIT_FAILURE;
+    }
+
+    /* Create the queue producers will attach to */
+    if(shmqueue_create(&q, queueName, size) == QUEUE_FAILURE){
+	fclose(outputfp);
+	return EXIT_FAILURE;
+    }
+    shmqueue_expect_producers(&q, producers);
+
+    /* Drain until the producers are done */
+    while(shmqueue_pop(&q, line, sizeof(line)) == QUEUE_SUCCESS){
+	fprintf(outputfp, "%s\n", line);
+    }
+
+    /* Cleanup */
+    shmqueue_detach(&q);
+    shmqueue_unlink(queueName);
+    fclose(outputfp);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/*
+ * File: daemonTest.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains test code for multi-lookup -d. It starts the
+ *      daemon with a small zone file, so answers do not depend on the
+ *      network, and sends requests the way a careless client would:
+ *      the last name without a trailing newline, and a connection
+ *      holding just one such name. Every name must be answered.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define SOCKET_PATH "daemonTest.sock"
+#define ZONE_FILE "daemonTest.hosts"
+#define ZONE "10.0.0.1 alpha.test\n10.0.0.2 beta.test\n10.0.0.3 gamma.test\n"
+#define CONNECT_TRIES 100
+
+/* Connect to the daemon, waiting for it to start listening */
+static int connect_daemon(void){
+    struct sockaddr_un addr;
+    int fd;
+    int i;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH, sizeof(addr.sun_path) - 1);
+    for(i=0; i<CONNECT_TRIES; i++){
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0){
+	    perror("socket");
+	    return -1;
+	}
+	if(!connect(fd, (struct sockaddr*)&addr, sizeof(addr))){
+	    return fd;
+	}
+	close(fd);
+	usleep(50000);
+    }
+    fprintf(stderr, "error: daemon is not listening on %s\n", SOCKET_PATH);
+    return -1;
+}
+
+/* Send request, close the write side, and check the answers that
+ * come back before the daemon closes the connection, in any order */
+static int check_session(const char* request, const char* const* answers, int nanswers){
+    char buf[4096];
+    size_t len = 0;
+    ssize_t n;
+    int lines = 0;
+    int errors = 0;
+    int i;
+    int fd = connect_daemon();
+
+    if(fd < 0){
+	return 1;
+    }
+    if(write(fd, request, strlen(request)) != (ssize_t)strlen(request) ||
+       shutdown(fd, SHUT_WR)){
+	perror("write");
+	close(fd);
+	return 1;
+    }
+    while(len < sizeof(buf) - 1 &&
+	  (n = read(fd, buf + len, sizeof(buf) - 1 - len)) > 0){
+	len += n;
+    }
+    buf[len] = '\0';
+    close(fd);
+
+    for(i=0; i<(int)len; i++){
+	lines += buf[i] == '\n';
+    }
+    if(lines != nanswers){
+	fprintf(stderr,
+		"error: %d answers to %d names\n"
+		"Request: %s\n"
+		"Output: %s\n",
+		lines, nanswers, request, buf);
+	errors++;
+    }
+    for(i=0; i<nanswers; i++){
+	if(!strstr(buf, answers[i])){
+	    fprintf(stderr,
+		    "error: missing answer!\n"
+		    "Expected: %s\n", answers[i]);
+	    errors++;
+	}
+    }
+    return errors;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static const char* const three[] = {
+	"alpha.test,10.0.0.1\n", "beta.test,10.0.0.2\n", "gamma.test,10.0.0.3\n"
+    };
+    static const char* const one[] = { "beta.test,10.0.0.2\n" };
+    FILE* fp;
+    int status;
+    int errors = 0;
+    pid_t pid;
+
+    fp = fopen(ZONE_FILE, "w");
+    if(!fp || fputs(ZONE, fp) == EOF || fclose(fp)){
+	perror("Error writing zone file");
+	return EXIT_FAILURE;
+    }
+
+    pid = fork();
+    if(pid < 0){
+	perror("fork");
+	return EXIT_FAILURE;
+    }
+    if(pid == 0){
+	execl("./multi-lookup", "multi-lookup", "-z", ZONE_FILE, "-d", SOCKET_PATH,
+	      (char*)NULL);
+	perror("Error starting ./multi-lookup");
+	_exit(EXIT_FAILURE);
+    }
+
+    /* Last name without a newline, with a CRLF and a blank line before */
+    errors += check_session("alpha.test\r\n\nbeta.test\ngamma.test", three, 3);
+    /* Nothing but one unterminated name */
+    errors += check_session("beta.test", one, 1);
+    /* And the usual, every name terminated */
+    errors += check_session("alpha.test\nbeta.test\ngamma.test\n", three, 3);
+
+    kill(pid, SIGTERM);
+    if(waitpid(pid, &status, 0) != pid ||
+       !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS){
+	fprintf(stderr,
+		"error: daemon did not exit cleanly\n");
+	errors++;
+    }
+    unlink(ZONE_FILE);
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
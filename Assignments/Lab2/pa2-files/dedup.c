@@ -0,0 +1,297 @@
+/*
+ * File: dedup.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the duplicate hostname filter used by
+ *      multi-lookup -D. A name the Bloom filter has never seen skips
+ *      the bucket scan and goes straight to insertion, so only names
+ *      the filter may have seen pay for a chain walk. A bounded set
+ *      drops the oldest resolved names of a stripe in batches and
+ *      then rebuilds that stripe's filter, which cannot forget a name
+ *      any other way.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "dedup.h"
+
+#define DEDUP_INITIAL_BUCKETS 64
+#define DEDUP_EVICT_FRACTION 8      /* a full stripe drops 1/8 of itself */
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Bloom probes by double hashing on the two halves of the hash,
+ * called with the stripe lock held */
+static bool bloom_test_and_set(dedup_set* set, dedup_stripe* s, uint64_t h){
+    uint64_t h1 = h;
+    uint64_t h2 = (h >> 32) | 1;
+    bool present = true;
+    int i;
+
+    for(i=0; i<DEDUP_BLOOM_HASHES; i++){
+	uint64_t bit = (h1 + i * h2) % set->bloomBits;
+	uint64_t mask = 1ULL << (bit & 63);
+	if(!(s->bloom[bit >> 6] & mask)){
+	    present = false;
+	    s->bloom[bit >> 6] |= mask;
+	}
+    }
+    return present;
+}
+
+static dedup_stripe* stripe_for(dedup_set* set, uint64_t h){
+    /* top bits pick the stripe, low bits the bucket inside it */
+    return &set->stripes[h >> 58];
+}
+
+static void stripe_grow(dedup_stripe* s){
+    size_t nbuckets = s->nbuckets * 2;
+    dedup_entry** buckets = calloc(nbuckets, sizeof(*buckets));
+    dedup_entry* e;
+    dedup_entry* next;
+    size_t i;
+
+    /* keep the old table if out of memory, chains just get longer */
+    if(!buckets){
+	return;
+    }
+    for(i=0; i<s->nbuckets; i++){
+	for(e=s->buckets[i]; e; e=next){
+	    next = e->next;
+	    e->next = buckets[e->hash & (nbuckets - 1)];
+	    buckets[e->hash & (nbuckets - 1)] = e;
+	}
+    }
+    free(s->buckets);
+    s->buckets = buckets;
+    s->nbuckets = nbuckets;
+}
+
+/* Take e out of its chain and the age list and free it */
+static void stripe_remove(dedup_stripe* s, dedup_entry* e){
+    dedup_entry** p = &s->buckets[e->hash & (s->nbuckets - 1)];
+
+    while(*p != e){
+	p = &(*p)->next;
+    }
+    *p = e->next;
+    if(e->older){
+	e->older->newer = e->newer;
+    }
+    else{
+	s->oldest = e->newer;
+    }
+    if(e->newer){
+	e->newer->older = e->older;
+    }
+    else{
+	s->newest = e->older;
+    }
+    s->count--;
+    free(e->answer);
+    free(e);
+}
+
+/* Drop the oldest resolved names until the stripe is a fraction under
+ * capacity, then rebuild its filter from the names left. Names still
+ * in flight are skipped, a resolver holds on to them. */
+static void stripe_evict(dedup_set* set, dedup_stripe* s){
+    size_t target = set->stripeCapacity - set->stripeCapacity / DEDUP_EVICT_FRACTION;
+    dedup_entry* e;
+    dedup_entry* newer;
+
+    for(e=s->oldest; e && s->count > target; e=newer){
+	newer = e->newer;
+	if(e->done){
+	    stripe_remove(s, e);
+	}
+    }
+    memset(s->bloom, 0, set->bloomBits / 8);
+    for(e=s->oldest; e; e=e->newer){
+	bloom_test_and_set(set, s, e->hash);
+    }
+}
+
+int dedup_init(dedup_set* set, size_t capacity, double ttl){
+    int i;
+
+    set->bloomBits = DEDUP_BLOOM_BITS / DEDUP_STRIPES;
+    set->stripeCapacity = 0;
+    if(capacity){
+	set->stripeCapacity = capacity / DEDUP_STRIPES;
+	if(set->stripeCapacity < DEDUP_EVICT_FRACTION){
+	    set->stripeCapacity = DEDUP_EVICT_FRACTION;
+	}
+    }
+    set->ttl = ttl;
+    for(i=0; i<DEDUP_STRIPES; i++){
+	dedup_stripe* s = &set->stripes[i];
+	pthread_mutex_init(&s->lock, NULL);
+	s->nbuckets = DEDUP_INITIAL_BUCKETS;
+	s->count = 0;
+	s->oldest = NULL;
+	s->newest = NULL;
+	s->buckets = calloc(s->nbuckets, sizeof(*s->buckets));
+	s->bloom = calloc(set->bloomBits / 64, sizeof(uint64_t));
+	if(!s->buckets || !s->bloom){
+	    perror("Error on dedup Malloc");
+	    return DEDUP_FAILURE;
+	}
+    }
+    return 0;
+}
+
+int dedup_insert(dedup_set* set, const char* hostname, void* ctx,
+		 dedup_entry** entry, ip_list_t* answer){
+    char key[DEDUP_MAX_KEY];
+    size_t len = name_normalize(hostname, key, sizeof(key));
+    uint64_t h = name_hash(key, len);
+    dedup_stripe* s = stripe_for(set, h);
+    dedup_entry* e;
+    int rv;
+
+    pthread_mutex_lock(&s->lock);
+
+    /* Tested under the stripe lock so two copies of one new name
+     * cannot both miss */
+    if(bloom_test_and_set(set, s, h)){
+	for(e=s->buckets[h & (s->nbuckets - 1)]; e; e=e->next){
+	    if(e->hash != h || strcmp(e->key, key)){
+		continue;
+	    }
+	    if(e->done && set->ttl && now() - e->completed > set->ttl){
+		/* stale, resolve it again as a first occurrence */
+		stripe_remove(s, e);
+		break;
+	    }
+	    if(e->done){
+		answer->naddrs = 0;
+		if(e->answer){
+		    answer->naddrs = e->answer->naddrs;
+		    memcpy(answer->addrs, e->answer->addrs,
+			   answer->naddrs * sizeof(ip_addr_t));
+		}
+		rv = DEDUP_DONE;
+	    }
+	    else{
+		/* park the repeat on the entry until the original is done */
+		size_t nlen = strlen(hostname) + 1;
+		dedup_waiter* w = malloc(sizeof(*w) + nlen);
+		if(!w){
+		    pthread_mutex_unlock(&s->lock);
+		    return DEDUP_FAILURE;
+		}
+		memcpy(w->hostname, hostname, nlen);
+		w->ctx = ctx;
+		w->next = e->waiters;
+		e->waiters = w;
+		rv = DEDUP_PENDING;
+	    }
+	    pthread_mutex_unlock(&s->lock);
+	    return rv;
+	}
+    }
+
+    /* first occurrence */
+    e = malloc(sizeof(*e) + len + 1);
+    if(!e){
+	pthread_mutex_unlock(&s->lock);
+	return DEDUP_FAILURE;
+    }
+    memcpy(e->key, key, len + 1);
+    e->hash = h;
+    e->done = false;
+    e->answer = NULL;
+    e->waiters = NULL;
+    e->completed = 0;
+    e->next = s->buckets[h & (s->nbuckets - 1)];
+    s->buckets[h & (s->nbuckets - 1)] = e;
+    e->older = s->newest;
+    e->newer = NULL;
+    if(s->newest){
+	s->newest->newer = e;
+    }
+    else{
+	s->oldest = e;
+    }
+    s->newest = e;
+    if(++s->count > s->nbuckets){
+	stripe_grow(s);
+    }
+    if(set->stripeCapacity && s->count > set->stripeCapacity){
+	stripe_evict(set, s);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    *entry = e;
+    return DEDUP_FIRST;
+}
+
+dedup_waiter* dedup_complete(dedup_set* set, dedup_entry* entry,
+			     const ip_list_t* answer){
+    dedup_stripe* s = stripe_for(set, entry->hash);
+    dedup_waiter* waiters;
+    size_t size = offsetof(ip_list_t, addrs)
+	+ answer->naddrs * sizeof(ip_addr_t);
+    ip_list_t* copy = malloc(size);
+
+    /* out of memory just means later repeats see no addresses */
+    if(copy){
+	memcpy(copy, answer, size);
+    }
+
+    pthread_mutex_lock(&s->lock);
+    entry->answer = copy;
+    entry->done = true;
+    if(set->ttl){
+	entry->completed = now();
+    }
+    waiters = entry->waiters;
+    entry->waiters = NULL;
+    pthread_mutex_unlock(&s->lock);
+
+    return waiters;
+}
+
+void dedup_free_waiters(dedup_waiter* waiters){
+    dedup_waiter* next;
+
+    for(; waiters; waiters=next){
+	next = waiters->next;
+	free(waiters);
+    }
+}
+
+void dedup_cleanup(dedup_set* set){
+    dedup_entry* e;
+    dedup_entry* next;
+    size_t b;
+    int i;
+
+    for(i=0; i<DEDUP_STRIPES; i++){
+	dedup_stripe* s = &set->stripes[i];
+	for(b=0; b<s->nbuckets; b++){
+	    for(e=s->buckets[b]; e; e=next){
+		next = e->next;
+		dedup_free_waiters(e->waiters);
+		free(e->answer);
+		free(e);
+	    }
+	}
+	free(s->buckets);
+	free(s->bloom);
+	pthread_mutex_destroy(&s->lock);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * File: dedup.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the duplicate hostname filter used
+ *      by multi-lookup -D. Names are normalized (lowercased, trailing
+ *      dots stripped) and kept in a lock striped hash set with a
+ *      Bloom filter in front of each stripe. The set can be bounded,
+ *      so it stays the same size in a process that runs for days:
+ *      past a capacity the oldest resolved names are dropped, and an
+ *      answer older than a TTL is not reused.
+ *
+ */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "util.h"
+
+#define DEDUP_FAILURE -1
+#define DEDUP_FIRST 0      /* first occurrence, caller must resolve it */
+#define DEDUP_PENDING 1    /* repeat of a name still being resolved */
+#define DEDUP_DONE 2       /* repeat of a resolved name, answer filled in */
+
+#define DEDUP_MAX_KEY 1025
+#define DEDUP_STRIPES 64
+#define DEDUP_BLOOM_BITS (1 << 23)        /* over all stripes */
+#define DEDUP_BLOOM_HASHES 4
+
+/* Bounds multi-lookup uses with -s and -d */
+#define DEDUP_STREAM_CAPACITY (1 << 20)   /* names */
+#define DEDUP_STREAM_TTL 300              /* seconds */
+
+/* A repeat waiting for its original to be resolved, kept with the
+ * spelling it had in the input */
+typedef struct dedup_waiter_s{
+    struct dedup_waiter_s* next;
+    void* ctx;              /* caller's context for the repeat */
+    char hostname[];
+} dedup_waiter;
+
+typedef struct dedup_entry_s{
+    struct dedup_entry_s* next;
+    struct dedup_entry_s* older;    /* insertion order, for eviction */
+    struct dedup_entry_s* newer;
+    uint64_t hash;
+    bool done;
+    double completed;       /* CLOCK_MONOTONIC, with a TTL */
+    ip_list_t* answer;      /* sized to the addresses found */
+    dedup_waiter* waiters;
+    char key[];
+} dedup_entry;
+
+/* One independently locked slice of the set */
+typedef struct dedup_stripe_s{
+    pthread_mutex_t lock;
+    dedup_entry** buckets;
+    size_t nbuckets;
+    size_t count;
+    dedup_entry* oldest;
+    dedup_entry* newest;
+    uint64_t* bloom;        /* rebuilt from what is left after evicting */
+} dedup_stripe;
+
+typedef struct dedup_set_s{
+    size_t bloomBits;       /* per stripe */
+    size_t stripeCapacity;  /* 0 for no limit */
+    double ttl;             /* seconds, 0 for no limit */
+    dedup_stripe stripes[DEDUP_STRIPES];
+} dedup_set;
+
+/* Function to initialize an empty set
+ * capacity is about how many names are kept, 0 for no limit
+ * ttl is how many seconds an answer is reused, 0 for no limit
+ * Returns 0 on success, DEDUP_FAILURE on failure
+ */
+int dedup_init(dedup_set* set, size_t capacity, double ttl);
+
+/* Function to record an occurrence of hostname
+ * On DEDUP_FIRST, *entry is the new entry to pass to dedup_complete
+ * On DEDUP_PENDING, the name and ctx will come back from dedup_complete
+ * On DEDUP_DONE, the recorded answer is copied into answer
+ * Returns DEDUP_FAILURE if memory runs out
+ */
+int dedup_insert(dedup_set* set, const char* hostname, void* ctx,
+		 dedup_entry** entry, ip_list_t* answer);
+
+/* Function to record the answer for a first occurrence
+ * Returns the repeats that arrived meanwhile, the caller writes
+ * them out and releases them with dedup_free_waiters
+ */
+dedup_waiter* dedup_complete(dedup_set* set, dedup_entry* entry,
+			     const ip_list_t* answer);
+
+/* Function to free a list returned by dedup_complete */
+void dedup_free_waiters(dedup_waiter* waiters);
+
+/* Function to free set memory */
+void dedup_cleanup(dedup_set* set);
+
+#endif
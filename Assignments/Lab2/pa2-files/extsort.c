@@ -0,0 +1,647 @@
+/*
+ * File: extsort.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the external sort and merge behind
+ *      multi-lookup -S.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+
+#include "extsort.h"
+
+/* One run's share of a merge range */
+typedef struct reader_s{
+    int fd;
+    uint64_t off;               /* next byte to read */
+    uint64_t end;
+    char* buf;
+    size_t cap;
+    size_t pos;
+    size_t len;
+    const char* line;
+    size_t lineLen;
+    uint64_t prefix;
+} reader;
+
+/* One merge thread: lines in [lower, upper) of every run */
+typedef struct part_s{
+    extsort* es;
+    const extsort_sample* lower;    /* NULL for the first range */
+    const extsort_sample* upper;    /* NULL for the last */
+    FILE* out;
+    size_t bufsize;
+    uint64_t linesOut;
+    int rv;
+} part;
+
+static uint64_t make_prefix(const char* s, size_t len){
+    uint64_t p = 0;
+    size_t i;
+
+    for(i=0; i<8; i++){
+	p <<= 8;
+	if(i < len){
+	    p |= (unsigned char)s[i];
+	}
+    }
+    return p;
+}
+
+static int compare_text(const char* a, size_t alen, const char* b, size_t blen){
+    int c = memcmp(a, b, alen < blen ? alen : blen);
+
+    if(c){
+	return c;
+    }
+    return alen < blen ? -1 : alen > blen;
+}
+
+static int cmp_lines(const void* a, const void* b){
+    const extsort_line* x = a;
+    const extsort_line* y = b;
+
+    if(x->prefix != y->prefix){
+	return x->prefix < y->prefix ? -1 : 1;
+    }
+    return compare_text(x->text, x->len, y->text, y->len);
+}
+
+static int cmp_samples(const void* a, const void* b){
+    const extsort_sample* x = *(const extsort_sample* const*)a;
+    const extsort_sample* y = *(const extsort_sample* const*)b;
+
+    return compare_text(x->key, x->len, y->key, y->len);
+}
+
+static extsort_line* batch_lines(const extsort_batch* b){
+    return (extsort_line*)(b->block + b->cap) - b->nlines;
+}
+
+static bool batch_add(extsort_batch* b, const char* line, size_t len){
+    extsort_line* l;
+
+    if(b->used + len + (b->nlines + 1) * sizeof(*l) > b->cap){
+	return false;
+    }
+    memcpy(b->block + b->used, line, len);
+    l = (extsort_line*)(b->block + b->cap) - (b->nlines + 1);
+    l->prefix = make_prefix(line, len);
+    l->text = b->block + b->used;
+    l->len = len;
+    b->used += len;
+    b->nlines++;
+    return true;
+}
+
+/* An unlinked file in the temporary directory */
+static FILE* open_temp(const char* dir){
+    char path[4096];
+    FILE* fp;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/multi-lookup-sort-XXXXXX", dir);
+    fd = mkstemp(path);
+    if(fd < 0){
+	perror("Error creating sort run");
+	return NULL;
+    }
+    unlink(path);
+    fp = fdopen(fd, "w+");
+    if(!fp){
+	perror("Error creating sort run");
+	close(fd);
+    }
+    return fp;
+}
+
+/* Sort a batch and write its distinct lines to out. With run set,
+ * every EXTSORT_SAMPLE_EVERY-th line is kept as an index entry. */
+static int write_sorted(extsort_batch* b, FILE* out, extsort_run* run,
+			uint64_t* linesOut){
+    extsort_line* lines = batch_lines(b);
+    const extsort_line* prev = NULL;
+    uint64_t written = 0;
+    size_t cap = 0;
+    size_t i;
+
+    qsort(lines, b->nlines, sizeof(*lines), cmp_lines);
+    for(i=0; i<b->nlines; i++){
+	const extsort_line* l = &lines[i];
+	if(prev && prev->prefix == l->prefix &&
+	   !compare_text(prev->text, prev->len, l->text, l->len)){
+	    continue;
+	}
+	if(run && written % EXTSORT_SAMPLE_EVERY == 0){
+	    extsort_sample* s;
+	    if(run->nsamples == cap){
+		cap = cap ? cap * 2 : 64;
+		s = realloc(run->samples, cap * sizeof(*s));
+		if(!s){
+		    perror("Error on sort Malloc");
+		    return EXTSORT_FAILURE;
+		}
+		run->samples = s;
+	    }
+	    s = &run->samples[run->nsamples];
+	    s->off = run->size;
+	    s->len = l->len;
+	    s->key = malloc(l->len ? l->len : 1);
+	    if(!s->key){
+		perror("Error on sort Malloc");
+		return EXTSORT_FAILURE;
+	    }
+	    memcpy(s->key, l->text, l->len);
+	    run->nsamples++;
+	}
+	fwrite(l->text, 1, l->len, out);
+	putc('\n', out);
+	if(run){
+	    run->size += l->len + 1;
+	}
+	written++;
+	prev = l;
+    }
+    b->used = 0;
+    b->nlines = 0;
+    *linesOut += written;
+
+    if(fflush(out)){
+	perror("Error writing sorted output");
+	return EXTSORT_FAILURE;
+    }
+    return EXTSORT_SUCCESS;
+}
+
+static int spill(extsort* es, extsort_batch* b){
+    extsort_run run;
+    uint64_t lines = 0;
+
+    memset(&run, 0, sizeof(run));
+    run.fp = open_temp(es->tmpdir);
+    if(!run.fp){
+	return EXTSORT_FAILURE;
+    }
+    if(write_sorted(b, run.fp, &run, &lines) == EXTSORT_FAILURE){
+	fclose(run.fp);
+	return EXTSORT_FAILURE;
+    }
+
+    pthread_mutex_lock(&es->lock);
+    if(es->nruns == es->runsCap){
+	size_t cap = es->runsCap ? es->runsCap * 2 : 16;
+	extsort_run* runs = realloc(es->runs, cap * sizeof(*runs));
+	if(!runs){
+	    pthread_mutex_unlock(&es->lock);
+	    perror("Error on sort Malloc");
+	    fclose(run.fp);
+	    return EXTSORT_FAILURE;
+	}
+	es->runs = runs;
+	es->runsCap = cap;
+    }
+    es->runs[es->nruns++] = run;
+    pthread_mutex_unlock(&es->lock);
+    return EXTSORT_SUCCESS;
+}
+
+/* Sorts and writes out full batches while the other one fills */
+static void* spill_thread(void* a){
+    extsort* es = a;
+
+    pthread_mutex_lock(&es->lock);
+    while(1){
+	extsort_batch* b;
+	int rv;
+	while(!es->pending && !es->stop){
+	    pthread_cond_wait(&es->cond, &es->lock);
+	}
+	if(!es->pending){
+	    break;
+	}
+	b = es->pending;
+	pthread_mutex_unlock(&es->lock);
+	rv = spill(es, b);
+	pthread_mutex_lock(&es->lock);
+	if(rv == EXTSORT_FAILURE){
+	    es->failed = true;
+	}
+	es->pending = NULL;
+	pthread_cond_broadcast(&es->cond);
+    }
+    pthread_mutex_unlock(&es->lock);
+    return NULL;
+}
+
+/* Give the full batch to the spiller and switch to the other one */
+static int hand_off(extsort* es){
+    pthread_mutex_lock(&es->lock);
+    while(es->pending){
+	pthread_cond_wait(&es->cond, &es->lock);
+    }
+    if(es->failed){
+	pthread_mutex_unlock(&es->lock);
+	return EXTSORT_FAILURE;
+    }
+    es->pending = &es->batches[es->cur];
+    pthread_cond_broadcast(&es->cond);
+    pthread_mutex_unlock(&es->lock);
+    es->cur ^= 1;
+    return EXTSORT_SUCCESS;
+}
+
+int extsort_init(extsort* es, size_t budget){
+    int i;
+
+    memset(es, 0, sizeof(*es));
+    if(budget < EXTSORT_MIN_BUDGET){
+	budget = EXTSORT_MIN_BUDGET;
+    }
+    es->budget = budget;
+    es->mergeThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    es->tmpdir = getenv("TMPDIR");
+    if(!es->tmpdir || !es->tmpdir[0]){
+	es->tmpdir = "/tmp";
+    }
+    for(i=0; i<2; i++){
+	/* line arrays grow down from the end, keep it aligned */
+	es->batches[i].cap = (budget / 2) & ~(size_t)(sizeof(extsort_line) - 1);
+	es->batches[i].block = malloc(es->batches[i].cap);
+	if(!es->batches[i].block){
+	    perror("Error on sort Malloc");
+	    return EXTSORT_FAILURE;
+	}
+    }
+    if(pthread_mutex_init(&es->lock, NULL) || pthread_cond_init(&es->cond, NULL)){
+	return EXTSORT_FAILURE;
+    }
+    if(pthread_create(&es->spiller, NULL, spill_thread, es)){
+	fprintf(stderr, "Error making sort thread\n");
+	return EXTSORT_FAILURE;
+    }
+    return EXTSORT_SUCCESS;
+}
+
+int extsort_add(extsort* es, const char* line, size_t len){
+    if(len > EXTSORT_MAX_LINE){
+	return EXTSORT_FAILURE;
+    }
+    if(!batch_add(&es->batches[es->cur], line, len)){
+	if(hand_off(es) == EXTSORT_FAILURE){
+	    return EXTSORT_FAILURE;
+	}
+	batch_add(&es->batches[es->cur], line, len);
+    }
+    es->linesIn++;
+    return EXTSORT_SUCCESS;
+}
+
+static bool reader_next(reader* r){
+    for(;;){
+	char* nl = memchr(r->buf + r->pos, '\n', r->len - r->pos);
+	ssize_t n;
+	if(nl){
+	    r->line = r->buf + r->pos;
+	    r->lineLen = nl - r->line;
+	    r->prefix = make_prefix(r->line, r->lineLen);
+	    r->pos = nl - r->buf + 1;
+	    return true;
+	}
+	memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+	r->len -= r->pos;
+	r->pos = 0;
+	if(r->off >= r->end || r->len == r->cap){
+	    return false;
+	}
+	n = pread(r->fd, r->buf + r->len, r->cap - r->len, r->off);
+	if(n <= 0){
+	    if(n < 0){
+		perror("Error reading sort run");
+	    }
+	    return false;
+	}
+	r->off += n;
+	r->len += n;
+    }
+}
+
+static int cmp_reader(const reader* r, const char* key, size_t len){
+    uint64_t p = make_prefix(key, len);
+
+    if(r->prefix != p){
+	return r->prefix < p ? -1 : 1;
+    }
+    return compare_text(r->line, r->lineLen, key, len);
+}
+
+static bool reader_less(const reader* a, const reader* b){
+    if(a->prefix != b->prefix){
+	return a->prefix < b->prefix;
+    }
+    return compare_text(a->line, a->lineLen, b->line, b->lineLen) < 0;
+}
+
+/* Advance to the next line still below the range's upper bound */
+static bool reader_advance(const part* p, reader* r){
+    if(!reader_next(r)){
+	return false;
+    }
+    return !p->upper || cmp_reader(r, p->upper->key, p->upper->len) < 0;
+}
+
+static void sift_down(reader* readers, size_t* heap, size_t n, size_t i){
+    for(;;){
+	size_t l = 2 * i + 1;
+	size_t m = i;
+	size_t t;
+	if(l < n && reader_less(&readers[heap[l]], &readers[heap[m]])){
+	    m = l;
+	}
+	if(l + 1 < n && reader_less(&readers[heap[l + 1]], &readers[heap[m]])){
+	    m = l + 1;
+	}
+	if(m == i){
+	    return;
+	}
+	t = heap[i];
+	heap[i] = heap[m];
+	heap[m] = t;
+	i = m;
+    }
+}
+
+/* Where to start reading a run for keys from lower on: the last index
+ * entry below lower */
+static uint64_t find_start(const extsort_run* run, const extsort_sample* lower){
+    size_t lo = 0;
+    size_t hi = run->nsamples;
+
+    while(lo < hi){
+	size_t mid = (lo + hi) / 2;
+	const extsort_sample* s = &run->samples[mid];
+	if(compare_text(s->key, s->len, lower->key, lower->len) < 0){
+	    lo = mid + 1;
+	}
+	else{
+	    hi = mid;
+	}
+    }
+    return lo ? run->samples[lo - 1].off : 0;
+}
+
+static void* merge_part(void* a){
+    part* p = a;
+    extsort* es = p->es;
+    reader* readers = calloc(es->nruns, sizeof(*readers));
+    size_t* heap = malloc(es->nruns * sizeof(*heap));
+    char* last = malloc(EXTSORT_MAX_LINE);
+    size_t lastLen = 0;
+    bool haveLast = false;
+    size_t n = 0;
+    size_t i;
+
+    p->rv = EXTSORT_FAILURE;
+    if(!readers || !heap || !last){
+	perror("Error on sort Malloc");
+	goto out;
+    }
+    for(i=0; i<es->nruns; i++){
+	reader* r = &readers[i];
+	r->fd = fileno(es->runs[i].fp);
+	r->off = p->lower ? find_start(&es->runs[i], p->lower) : 0;
+	r->end = es->runs[i].size;
+	r->cap = p->bufsize;
+	r->buf = malloc(r->cap);
+	if(!r->buf){
+	    perror("Error on sort Malloc");
+	    goto out;
+	}
+	/* skip to the first line of this range */
+	while(reader_next(r)){
+	    if(p->lower && cmp_reader(r, p->lower->key, p->lower->len) < 0){
+		continue;
+	    }
+	    if(!p->upper || cmp_reader(r, p->upper->key, p->upper->len) < 0){
+		heap[n++] = i;
+	    }
+	    break;
+	}
+    }
+    for(i=n; i-- > 0;){
+	sift_down(readers, heap, n, i);
+    }
+
+    while(n > 0){
+	reader* r = &readers[heap[0]];
+	if(!haveLast || compare_text(last, lastLen, r->line, r->lineLen)){
+	    fwrite(r->line, 1, r->lineLen, p->out);
+	    putc('\n', p->out);
+	    memcpy(last, r->line, r->lineLen);
+	    lastLen = r->lineLen;
+	    haveLast = true;
+	    p->linesOut++;
+	}
+	if(!reader_advance(p, r)){
+	    heap[0] = heap[--n];
+	}
+	sift_down(readers, heap, n, 0);
+    }
+    if(fflush(p->out)){
+	perror("Error writing sorted output");
+	goto out;
+    }
+    p->rv = EXTSORT_SUCCESS;
+
+out:
+    if(readers){
+	for(i=0; i<es->nruns; i++){
+	    free(readers[i].buf);
+	}
+    }
+    free(readers);
+    free(heap);
+    free(last);
+    return NULL;
+}
+
+/* Append a finished range to out without copying it through here */
+static int append_file(FILE* out, FILE* in){
+    char buf[EXTSORT_IOBUFSIZE];
+    off_t off = 0;
+    off_t size;
+    ssize_t n;
+
+    if(fflush(out) || fflush(in)){
+	return EXTSORT_FAILURE;
+    }
+    size = lseek(fileno(in), 0, SEEK_END);
+    while(off < size){
+	n = sendfile(fileno(out), fileno(in), &off, size - off);
+	if(n > 0){
+	    continue;
+	}
+	if(n < 0 && (errno == EINVAL || errno == ENOSYS)){
+	    break;
+	}
+	return EXTSORT_FAILURE;
+    }
+    /* sendfile does not take every kind of output */
+    while(off < size){
+	n = pread(fileno(in), buf, sizeof(buf), off);
+	if(n <= 0 || fwrite(buf, 1, n, out) != (size_t)n){
+	    return EXTSORT_FAILURE;
+	}
+	off += n;
+    }
+    return EXTSORT_SUCCESS;
+}
+
+static int merge_runs(extsort* es, FILE* out){
+    extsort_sample** all = NULL;
+    size_t nall = 0;
+    size_t i;
+    int nparts = es->mergeThreads < 1 ? 1 :
+	es->mergeThreads > EXTSORT_MAX_MERGE ? EXTSORT_MAX_MERGE : es->mergeThreads;
+    size_t bufsize;
+    int rv = EXTSORT_SUCCESS;
+    int k;
+
+    for(i=0; i<es->nruns; i++){
+	nall += es->runs[i].nsamples;
+    }
+    if((size_t)nparts > nall){
+	nparts = nall ? nall : 1;
+    }
+    /* every merge thread reads every run, the buffers share the budget */
+    bufsize = es->budget / ((size_t)nparts * es->nruns);
+    while(nparts > 1 && bufsize < 2 * EXTSORT_MAX_LINE){
+	nparts--;
+	bufsize = es->budget / ((size_t)nparts * es->nruns);
+    }
+    if(bufsize < 2 * EXTSORT_MAX_LINE){
+	bufsize = 2 * EXTSORT_MAX_LINE;
+    }
+    if(bufsize > EXTSORT_IOBUFSIZE){
+	bufsize = EXTSORT_IOBUFSIZE;
+    }
+    es->mergeThreads = nparts;
+
+    /* split the key space where the sampled keys split it evenly */
+    all = malloc((nall ? nall : 1) * sizeof(*all));
+    if(!all){
+	perror("Error on sort Malloc");
+	return EXTSORT_FAILURE;
+    }
+    nall = 0;
+    for(i=0; i<es->nruns; i++){
+	size_t s;
+	for(s=0; s<es->runs[i].nsamples; s++){
+	    all[nall++] = &es->runs[i].samples[s];
+	}
+    }
+    qsort(all, nall, sizeof(*all), cmp_samples);
+
+    pthread_t threads[nparts];
+    part parts[nparts];
+    for(k=0; k<nparts; k++){
+	memset(&parts[k], 0, sizeof(parts[k]));
+	parts[k].es = es;
+	parts[k].lower = k ? all[(size_t)k * nall / nparts] : NULL;
+	parts[k].upper = k < nparts - 1 ? all[(size_t)(k + 1) * nall / nparts] : NULL;
+	parts[k].bufsize = bufsize;
+	/* the first range goes straight to the output */
+	parts[k].out = k ? open_temp(es->tmpdir) : out;
+	if(!parts[k].out){
+	    rv = EXTSORT_FAILURE;
+	    nparts = k;
+	    break;
+	}
+    }
+    for(k=0; k<nparts; k++){
+	if(pthread_create(&threads[k], NULL, merge_part, &parts[k])){
+	    fprintf(stderr, "Error making merge thread\n");
+	    exit(EXIT_FAILURE);
+	}
+    }
+    for(k=0; k<nparts; k++){
+	pthread_join(threads[k], NULL);
+	if(parts[k].rv == EXTSORT_FAILURE){
+	    rv = EXTSORT_FAILURE;
+	}
+	es->linesOut += parts[k].linesOut;
+    }
+    for(k=1; k<nparts; k++){
+	if(rv == EXTSORT_SUCCESS && append_file(out, parts[k].out) == EXTSORT_FAILURE){
+	    perror("Error writing sorted output");
+	    rv = EXTSORT_FAILURE;
+	}
+	fclose(parts[k].out);
+    }
+
+    free(all);
+    return rv;
+}
+
+int extsort_finish(extsort* es, FILE* out){
+    bool spilled;
+    int rv = EXTSORT_SUCCESS;
+    size_t i;
+    size_t s;
+
+    pthread_mutex_lock(&es->lock);
+    spilled = es->pending || es->nruns > 0;
+    pthread_mutex_unlock(&es->lock);
+
+    if(spilled && es->batches[es->cur].nlines > 0){
+	rv = hand_off(es);
+    }
+
+    /* wait for the last spill and stop the spiller */
+    pthread_mutex_lock(&es->lock);
+    while(es->pending){
+	pthread_cond_wait(&es->cond, &es->lock);
+    }
+    es->stop = true;
+    pthread_cond_broadcast(&es->cond);
+    pthread_mutex_unlock(&es->lock);
+    pthread_join(es->spiller, NULL);
+    if(es->failed){
+	rv = EXTSORT_FAILURE;
+    }
+
+    if(rv == EXTSORT_SUCCESS){
+	if(!spilled){
+	    /* everything fit, no run files at all */
+	    es->mergeThreads = 0;
+	    rv = write_sorted(&es->batches[es->cur], out, NULL, &es->linesOut);
+	}
+	else{
+	    rv = merge_runs(es, out);
+	}
+    }
+
+    for(i=0; i<es->nruns; i++){
+	for(s=0; s<es->runs[i].nsamples; s++){
+	    free(es->runs[i].samples[s].key);
+	}
+	free(es->runs[i].samples);
+	fclose(es->runs[i].fp);
+    }
+    free(es->runs);
+    es->runs = NULL;
+    for(i=0; i<2; i++){
+	free(es->batches[i].block);
+	es->batches[i].block = NULL;
+    }
+    pthread_mutex_destroy(&es->lock);
+    pthread_cond_destroy(&es->cond);
+    return rv;
+}
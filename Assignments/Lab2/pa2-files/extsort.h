@@ -0,0 +1,104 @@
+/*
+ * File: extsort.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the sort -u finishing stage of
+ *      multi-lookup -S. Result lines are collected under a memory
+ *      budget. Whenever half the budget fills up, a background thread
+ *      sorts that half and spills it to a temporary run file while
+ *      the other half keeps filling. At the end the runs are merged
+ *      in parallel: sampled keys split the key space into ranges, each
+ *      merge thread merges one range of every run, and the ranges are
+ *      concatenated. Lines compare as bytes, like LC_ALL=C sort -u.
+ *
+ */
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define EXTSORT_FAILURE -1
+#define EXTSORT_SUCCESS 0
+
+#define EXTSORT_MAX_LINE 4096
+#define EXTSORT_MIN_BUDGET (1 << 20)
+#define EXTSORT_SAMPLE_EVERY 1024   /* lines between run index entries */
+#define EXTSORT_MAX_MERGE 8         /* merge threads */
+#define EXTSORT_IOBUFSIZE (64 * 1024)
+
+/* A line in a batch, the prefix makes most compares one integer compare */
+typedef struct extsort_line_s{
+    uint64_t prefix;            /* first 8 bytes, big endian, zero padded */
+    const char* text;
+    size_t len;                 /* without the newline */
+} extsort_line;
+
+/* Half the budget: text grows up from the start of the block and the
+ * line array grows down from the end */
+typedef struct extsort_batch_s{
+    char* block;
+    size_t cap;
+    size_t used;
+    size_t nlines;
+} extsort_batch;
+
+typedef struct extsort_sample_s{
+    uint64_t off;               /* where the line starts in the run */
+    char* key;
+    size_t len;
+} extsort_sample;
+
+/* One sorted, duplicate free run file */
+typedef struct extsort_run_s{
+    FILE* fp;                   /* unlinked temporary file */
+    uint64_t size;
+    extsort_sample* samples;
+    size_t nsamples;
+} extsort_run;
+
+typedef struct extsort_s{
+    size_t budget;
+    const char* tmpdir;
+    extsort_batch batches[2];
+    int cur;                    /* batch being filled */
+    pthread_t spiller;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    extsort_batch* pending;     /* handed to the spiller, NULL when idle */
+    bool stop;
+    bool failed;
+    extsort_run* runs;
+    size_t nruns;
+    size_t runsCap;
+    uint64_t linesIn;
+    uint64_t linesOut;
+    int mergeThreads;           /* most to use, the cpu count from init,
+				 * after finish the number used */
+} extsort;
+
+/* Function to set up a sorter that keeps at most budget bytes of lines
+ * in memory. Runs go to $TMPDIR, or /tmp.
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE
+ */
+int extsort_init(extsort* es, size_t budget);
+
+/* Function to add one line, len bytes without a newline. Not thread
+ * safe, callers serialize (multi-lookup holds the output lock).
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE
+ */
+int extsort_add(extsort* es, const char* line, size_t len);
+
+/* Function to write every distinct line to out in order, each with a
+ * newline, and free the sorter
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE
+ */
+int extsort_finish(extsort* es, FILE* out);
+
+#endif
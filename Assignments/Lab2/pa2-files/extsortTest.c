@@ -0,0 +1,121 @@
+/*
+ * File: extsortTest.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains test code for the sort -u stage. Enough
+ *      lines, with plenty of repeats, go through the smallest budget
+ *      to spill many runs, the merge is split over several threads
+ *      whatever the cpu count, and the output has to match
+ *      LC_ALL=C sort -u of the same lines byte for byte.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "extsort.h"
+
+#define TEST_SIZE 200000
+#define TEST_KEYS 60000
+#define TEST_MERGE 4
+#define INPUT_FILE "extsortTest.in"
+#define OUTPUT_FILE "extsortTest.out"
+#define CHECK_CMD "LC_ALL=C sort -u " INPUT_FILE " | cmp - " OUTPUT_FILE
+
+/* The line for key k. The same key always gives the same line, so
+ * repeats land in different runs. Some lines share more than the 8
+ * byte prefix, some have bytes above 0x7f, lengths vary. */
+static size_t make_line(int k, char* line, size_t size){
+    int len;
+
+    switch(k % 4){
+    case 0:
+	len = snprintf(line, size, "host%d.example.com,10.%d.%d.%d",
+		       k, k & 0xff, (k >> 8) & 0xff, k % 7);
+	break;
+    case 1:
+	len = snprintf(line, size, "same-long-prefix.example.net,%d", k);
+	break;
+    case 2:
+	len = snprintf(line, size, "\xc3\xa9t\xc3\xa9-%d.example.org", k);
+	break;
+    default:
+	len = snprintf(line, size, "%0*d", 1 + k % 120, k);
+	break;
+    }
+    return len;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    extsort es;
+    FILE* in;
+    FILE* out;
+    char line[256];
+    size_t len;
+    int errors = 0;
+    int i;
+
+    in = fopen(INPUT_FILE, "w");
+    out = fopen(OUTPUT_FILE, "w");
+    if(!in || !out){
+	perror("Error opening test files");
+	return EXIT_FAILURE;
+    }
+    if(extsort_init(&es, EXTSORT_MIN_BUDGET) == EXTSORT_FAILURE){
+	fprintf(stderr, "error: extsort_init failed!\n");
+	return EXIT_FAILURE;
+    }
+    es.mergeThreads = TEST_MERGE;
+
+    srand(3753);
+    for(i=0; i<TEST_SIZE; i++){
+	len = make_line(rand() % TEST_KEYS, line, sizeof(line));
+	fprintf(in, "%s\n", line);
+	if(extsort_add(&es, line, len) == EXTSORT_FAILURE){
+	    fprintf(stderr, "error: extsort_add failed!\n");
+	    return EXIT_FAILURE;
+	}
+    }
+    if(fclose(in) || extsort_finish(&es, out) == EXTSORT_FAILURE || fclose(out)){
+	fprintf(stderr, "error: extsort_finish failed!\n");
+	return EXIT_FAILURE;
+    }
+
+    /* Make sure the spill and parallel merge paths ran */
+    if(es.nruns < 2){
+	fprintf(stderr, "error: %zu runs, expected several spills\n", es.nruns);
+	errors++;
+    }
+    if(es.mergeThreads < 2){
+	fprintf(stderr, "error: %d merge threads, expected several\n",
+		es.mergeThreads);
+	errors++;
+    }
+    if(es.linesIn != TEST_SIZE){
+	fprintf(stderr, "error: %llu lines in, expected %d\n",
+		(unsigned long long)es.linesIn, TEST_SIZE);
+	errors++;
+    }
+
+    if(system(CHECK_CMD)){
+	fprintf(stderr, "error: output differs from sort -u\n");
+	errors++;
+    }
+
+    /* Cleanup */
+    unlink(INPUT_FILE);
+    unlink(OUTPUT_FILE);
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,437 @@
+/*
+ * File: fileio.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the asynchronous file I/O layer. Other
+ *      threads only queue ops and wait for them to complete. The I/O
+ *      thread moves queued ops into the ring in batches, and sleeps in
+ *      io_uring_enter until something completes. A read of an eventfd
+ *      is kept in the ring so that queuing new ops wakes it up.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "fileio.h"
+
+static char* op_data(fileio* io, fileio_op* op){
+    return io->pool + (size_t) op->buf * FILEIO_BUFSIZE;
+}
+
+/* Queue an op for the I/O thread, with io->lock held */
+static void enqueue(fileio* io, fileio_op* op){
+    op->busy = true;
+    op->next = NULL;
+    *io->queuedTail = op;
+    io->queuedTail = &op->next;
+}
+
+/* Wake the I/O thread after queuing, without io->lock */
+static void wake(fileio* io){
+    uint64_t one = 1;
+
+    if(io->useRing){
+	if(write(io->wakeFd, &one, sizeof(one)) < 0){
+	    perror("Error waking I/O thread");
+	}
+    }
+    else{
+	pthread_cond_signal(&io->work);
+    }
+}
+
+static fileio_op* dequeue(fileio* io){
+    fileio_op* op = io->queued;
+
+    io->queued = op->next;
+    if(!io->queued){
+	io->queuedTail = &io->queued;
+    }
+    return op;
+}
+
+/* Record a result, with io->lock held. A short write is queued
+ * again for the rest. */
+static void complete(fileio* io, fileio_op* op, ssize_t res){
+    if(op->type == FILEIO_OP_WRITE){
+	if(res < 0){
+	    io->writeErr = (int) -res;
+	}
+	else if(op->done + res < op->len){
+	    op->done += res;
+	    enqueue(io, op);
+	    return;
+	}
+    }
+    op->res = res;
+    op->busy = false;
+}
+
+static void prep(fileio* io, struct io_uring_sqe* sqe, fileio_op* op){
+    bool write = op->type == FILEIO_OP_WRITE;
+
+    if(io->fixed){
+	sqe->opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+	sqe->buf_index = op->buf;
+    }
+    else{
+	sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+    }
+    sqe->fd = op->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(op_data(io, op) + op->done);
+    sqe->len = op->len - op->done;
+    sqe->off = op->off + op->done;
+    sqe->user_data = (uint64_t)(uintptr_t) op;
+}
+
+static void* ring_thread(void* a){
+    fileio* io = a;
+    struct io_uring_sqe* sqe;
+    struct io_uring_cqe cqe;
+
+    pthread_mutex_lock(&io->lock);
+    for(;;){
+	/* batch everything queued since the last pass */
+	while(io->queued && (sqe = uring_get_sqe(&io->ring)) != NULL){
+	    prep(io, sqe, dequeue(io));
+	    io->inflight++;
+	}
+	if(!io->wakeArmed && (sqe = uring_get_sqe(&io->ring)) != NULL){
+	    sqe->opcode = IORING_OP_READ;
+	    sqe->fd = io->wakeFd;
+	    sqe->addr = (uint64_t)(uintptr_t) &io->wakeVal;
+	    sqe->len = sizeof(io->wakeVal);
+	    sqe->off = (uint64_t) -1;
+	    sqe->user_data = 0;
+	    io->wakeArmed = true;
+	}
+	if(io->stopping && io->inflight == 0 && !io->queued){
+	    break;
+	}
+	pthread_mutex_unlock(&io->lock);
+
+	if(uring_submit(&io->ring, 1) == URING_FAILURE){
+	    perror("Error submitting to io_uring");
+	}
+
+	pthread_mutex_lock(&io->lock);
+	while(uring_next_cqe(&io->ring, &cqe)){
+	    if(cqe.user_data == 0){
+		io->wakeArmed = false;
+		continue;
+	    }
+	    io->inflight--;
+	    complete(io, (fileio_op*)(uintptr_t) cqe.user_data, cqe.res);
+	}
+	pthread_cond_broadcast(&io->done);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    return NULL;
+}
+
+static void* sync_thread(void* a){
+    fileio* io = a;
+    fileio_op* op;
+    ssize_t res;
+
+    pthread_mutex_lock(&io->lock);
+    for(;;){
+	while(!io->queued && !io->stopping){
+	    pthread_cond_wait(&io->work, &io->lock);
+	}
+	if(!io->queued){
+	    break;
+	}
+	op = dequeue(io);
+	pthread_mutex_unlock(&io->lock);
+
+	if(op->type == FILEIO_OP_READ){
+	    res = pread(op->fd, op_data(io, op), op->len, op->off);
+	}
+	else{
+	    res = pwrite(op->fd, op_data(io, op) + op->done,
+			 op->len - op->done, op->off + op->done);
+	}
+	if(res < 0){
+	    res = -errno;
+	}
+
+	pthread_mutex_lock(&io->lock);
+	complete(io, op, res);
+	pthread_cond_broadcast(&io->done);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    return NULL;
+}
+
+int fileio_init(fileio* io, int nreaders, const char* outputPath){
+    struct iovec* iov;
+    int i;
+
+    memset(io, 0, sizeof(*io));
+    io->wakeFd = -1;
+    io->outFd = -1;
+    io->wcur = -1;
+    io->queuedTail = &io->queued;
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->work, NULL);
+    pthread_cond_init(&io->done, NULL);
+
+    io->nbufs = nreaders * FILEIO_READ_DEPTH + FILEIO_WRITE_BUFS;
+    if(posix_memalign((void**)&io->pool, 4096,
+		      (size_t) io->nbufs * FILEIO_BUFSIZE)){
+	fprintf(stderr, "Error on fileio Malloc\n");
+	return FILEIO_FAILURE;
+    }
+    io->freeBufs = malloc(io->nbufs * sizeof(*io->freeBufs));
+    if(!io->freeBufs){
+	perror("Error on fileio Malloc");
+	return FILEIO_FAILURE;
+    }
+    /* the first buffers belong to the writer, the rest to readers */
+    for(i=0; i<FILEIO_WRITE_BUFS; i++){
+	io->wops[i].type = FILEIO_OP_WRITE;
+	io->wops[i].buf = i;
+    }
+    for(i=FILEIO_WRITE_BUFS; i<io->nbufs; i++){
+	io->freeBufs[io->nfree++] = i;
+    }
+
+    if(outputPath){
+	io->outFd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	if(io->outFd < 0){
+	    perror("Error opening output file");
+	    return FILEIO_FAILURE;
+	}
+    }
+
+    io->useRing = uring_init(&io->ring, FILEIO_RING_ENTRIES) == URING_SUCCESS;
+    if(io->useRing){
+	io->wakeFd = eventfd(0, EFD_CLOEXEC);
+	if(io->wakeFd < 0){
+	    uring_cleanup(&io->ring);
+	    io->useRing = false;
+	}
+    }
+    if(io->useRing){
+	/* fixed buffers save pinning pages on every op, but count
+	 * against RLIMIT_MEMLOCK, so plain reads/writes if refused */
+	iov = malloc(io->nbufs * sizeof(*iov));
+	if(iov){
+	    for(i=0; i<io->nbufs; i++){
+		iov[i].iov_base = io->pool + (size_t) i * FILEIO_BUFSIZE;
+		iov[i].iov_len = FILEIO_BUFSIZE;
+	    }
+	    io->fixed = uring_register_buffers(&io->ring, iov, io->nbufs)
+		== URING_SUCCESS;
+	    free(iov);
+	}
+    }
+
+    if(pthread_create(&io->thread, NULL,
+		      io->useRing ? ring_thread : sync_thread, io)){
+	fprintf(stderr, "Error making I/O thread\n");
+	return FILEIO_FAILURE;
+    }
+    return FILEIO_SUCCESS;
+}
+
+fileio_reader* fileio_open(fileio* io, const char* path){
+    fileio_reader* r;
+    int k;
+
+    r = calloc(1, sizeof(*r));
+    if(!r){
+	return NULL;
+    }
+    r->io = io;
+    r->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(r->fd < 0){
+	int err = errno;
+	free(r);
+	errno = err;
+	return NULL;
+    }
+    posix_fadvise(r->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    pthread_mutex_lock(&io->lock);
+    /* there are buffers for every reader, but wait rather than trust it */
+    while(io->nfree < FILEIO_READ_DEPTH){
+	pthread_cond_wait(&io->done, &io->lock);
+    }
+    for(k=0; k<FILEIO_READ_DEPTH; k++){
+	fileio_op* op = &r->ops[k];
+	op->type = FILEIO_OP_READ;
+	op->fd = r->fd;
+	op->buf = io->freeBufs[--io->nfree];
+	op->off = r->nextOff;
+	op->len = FILEIO_BUFSIZE;
+	r->nextOff += FILEIO_BUFSIZE;
+	enqueue(io, op);
+    }
+    pthread_mutex_unlock(&io->lock);
+    wake(io);
+
+    return r;
+}
+
+ssize_t fileio_read(fileio_reader* r, const char** data){
+    fileio* io = r->io;
+    fileio_op* op;
+    bool queued = false;
+    ssize_t n;
+
+    pthread_mutex_lock(&io->lock);
+    if(r->held){
+	/* the parser is done with it, read further ahead into it */
+	op = &r->ops[r->head];
+	if(!r->eof){
+	    op->off = r->nextOff;
+	    r->nextOff += FILEIO_BUFSIZE;
+	    enqueue(io, op);
+	    queued = true;
+	}
+	r->head = (r->head + 1) % FILEIO_READ_DEPTH;
+	r->held = false;
+    }
+    op = &r->ops[r->head];
+    while(op->busy){
+	pthread_cond_wait(&io->done, &io->lock);
+    }
+    n = op->res;
+    if(n < FILEIO_BUFSIZE){
+	/* reads queued after this one are all past the end */
+	r->eof = true;
+    }
+    if(n > 0){
+	r->held = true;
+	*data = op_data(io, op);
+    }
+    pthread_mutex_unlock(&io->lock);
+    if(queued){
+	wake(io);
+    }
+
+    if(n < 0){
+	errno = (int) -n;
+	return -1;
+    }
+    return n;
+}
+
+void fileio_close(fileio_reader* r){
+    fileio* io = r->io;
+    int k;
+
+    pthread_mutex_lock(&io->lock);
+    for(k=0; k<FILEIO_READ_DEPTH; k++){
+	while(r->ops[k].busy){
+	    pthread_cond_wait(&io->done, &io->lock);
+	}
+	io->freeBufs[io->nfree++] = r->ops[k].buf;
+    }
+    pthread_cond_broadcast(&io->done);
+    pthread_mutex_unlock(&io->lock);
+
+    close(r->fd);
+    free(r);
+}
+
+/* Hand the buffer being filled to the I/O thread, with io->lock held */
+static void queue_write(fileio* io){
+    fileio_op* op = &io->wops[io->wcur];
+
+    op->fd = io->outFd;
+    op->off = io->writeOff;
+    op->len = io->wlen;
+    op->done = 0;
+    io->writeOff += io->wlen;
+    enqueue(io, op);
+    io->wcur = -1;
+}
+
+int fileio_append(fileio* io, const char* data, size_t len){
+    bool queued = false;
+    int k;
+
+    if(len > FILEIO_BUFSIZE){
+	return FILEIO_FAILURE;
+    }
+
+    pthread_mutex_lock(&io->lock);
+    if(io->wcur >= 0 && io->wlen + len > FILEIO_BUFSIZE){
+	queue_write(io);
+	queued = true;
+    }
+    while(io->wcur < 0){
+	for(k=0; k<FILEIO_WRITE_BUFS; k++){
+	    if(!io->wops[k].busy){
+		io->wcur = k;
+		io->wlen = 0;
+		break;
+	    }
+	}
+	if(io->wcur < 0){
+	    /* every buffer is being written, the disk is behind */
+	    if(queued){
+		wake(io);
+		queued = false;
+	    }
+	    pthread_cond_wait(&io->done, &io->lock);
+	}
+    }
+    memcpy(op_data(io, &io->wops[io->wcur]) + io->wlen, data, len);
+    io->wlen += len;
+    pthread_mutex_unlock(&io->lock);
+
+    if(queued){
+	wake(io);
+    }
+    return FILEIO_SUCCESS;
+}
+
+int fileio_cleanup(fileio* io){
+    int err;
+
+    pthread_mutex_lock(&io->lock);
+    if(io->wcur >= 0 && io->wlen > 0){
+	queue_write(io);
+    }
+    io->stopping = true;
+    pthread_mutex_unlock(&io->lock);
+    wake(io);
+
+    /* the thread only exits once every queued op is done */
+    pthread_join(io->thread, NULL);
+
+    if(io->useRing){
+	uring_cleanup(&io->ring);
+	close(io->wakeFd);
+    }
+    err = io->writeErr;
+    if(io->outFd >= 0 && close(io->outFd) && !err){
+	err = errno;
+    }
+    free(io->pool);
+    free(io->freeBufs);
+    pthread_mutex_destroy(&io->lock);
+    pthread_cond_destroy(&io->work);
+    pthread_cond_destroy(&io->done);
+
+    if(err){
+	errno = err;
+	perror("Error writing output file");
+	return FILEIO_FAILURE;
+    }
+    return FILEIO_SUCCESS;
+}
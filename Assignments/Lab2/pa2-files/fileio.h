@@ -0,0 +1,124 @@
+/*
+ * File: fileio.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the asynchronous file I/O layer of
+ *      multi-lookup -i uring. A dedicated I/O thread owns an io_uring
+ *      and a pool of registered buffers. Producers get input files
+ *      as chunks that were read ahead of them, and resolvers append
+ *      results into buffers that are written out in batches, so
+ *      neither ever waits in a system call for the disk. Without
+ *      io_uring the I/O thread does the same with pread/pwrite.
+ *
+ */
+
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "uring.h"
+
+#define FILEIO_FAILURE -1
+#define FILEIO_SUCCESS 0
+
+#define FILEIO_BUFSIZE (64 * 1024)
+#define FILEIO_READ_DEPTH 4     /* chunk reads in flight per input file */
+#define FILEIO_WRITE_BUFS 8     /* result buffers filling or being written */
+#define FILEIO_RING_ENTRIES 256
+
+#define FILEIO_OP_READ 0
+#define FILEIO_OP_WRITE 1
+
+struct fileio_s;
+
+/* One read or write of one pool buffer */
+typedef struct fileio_op_s{
+    struct fileio_op_s* next;   /* on the queued list */
+    int type;
+    int fd;
+    int buf;                    /* index into the buffer pool */
+    off_t off;
+    size_t len;
+    size_t done;                /* bytes of a write already written */
+    ssize_t res;                /* bytes read, or -errno */
+    bool busy;                  /* queued or in flight */
+} fileio_op;
+
+/* An input file read FILEIO_READ_DEPTH chunks ahead of the parser.
+ * Meant for regular files, where only the last read comes back short */
+typedef struct fileio_reader_s{
+    struct fileio_s* io;
+    int fd;
+    off_t nextOff;              /* offset of the next read to queue */
+    fileio_op ops[FILEIO_READ_DEPTH];
+    int head;                   /* op the parser gets next */
+    bool held;                  /* parser still holds head's buffer */
+    bool eof;                   /* a short read, queue nothing more */
+} fileio_reader;
+
+typedef struct fileio_s{
+    bool useRing;               /* false: pread/pwrite fallback */
+    bool fixed;                 /* buffers registered with the ring */
+    uring ring;
+    int wakeFd;                 /* eventfd, wakes the ring thread */
+    uint64_t wakeVal;
+    bool wakeArmed;             /* a read of wakeFd is in the ring */
+    pthread_t thread;
+    pthread_mutex_t lock;       /* guards everything below */
+    pthread_cond_t work;        /* fallback: ops were queued */
+    pthread_cond_t done;        /* some op completed */
+    fileio_op* queued;
+    fileio_op** queuedTail;
+    unsigned inflight;
+    bool stopping;
+    char* pool;
+    int nbufs;
+    int* freeBufs;              /* pool buffers not given to a reader */
+    int nfree;
+    /* results file */
+    int outFd;
+    off_t writeOff;             /* where the next full buffer goes */
+    fileio_op wops[FILEIO_WRITE_BUFS];
+    int wcur;                   /* buffer being filled, -1 for none */
+    size_t wlen;
+    int writeErr;
+} fileio;
+
+/* Function to start the I/O thread
+ * nreaders is the most input files open at once. outputPath is
+ * created (or truncated) for fileio_append, NULL for none.
+ * Returns FILEIO_SUCCESS or FILEIO_FAILURE
+ */
+int fileio_init(fileio* io, int nreaders, const char* outputPath);
+
+/* Function to open an input file and start reading ahead
+ * Returns the reader, or NULL with errno set
+ */
+fileio_reader* fileio_open(fileio* io, const char* path);
+
+/* Function to get the next chunk of the file, waiting for it if it
+ * has not been read yet. The previous chunk is given back.
+ * Returns its length, 0 at end of file, or -1 with errno set
+ */
+ssize_t fileio_read(fileio_reader* r, const char** data);
+
+/* Function to close an input file once its reads have finished */
+void fileio_close(fileio_reader* r);
+
+/* Function to append to the results file, safe from any thread
+ * Returns FILEIO_SUCCESS, or FILEIO_FAILURE if len is over a buffer
+ */
+int fileio_append(fileio* io, const char* data, size_t len);
+
+/* Function to write out what is buffered and stop the I/O thread
+ * Returns FILEIO_FAILURE if any write failed
+ */
+int fileio_cleanup(fileio* io);
+
+#endif
@@ -0,0 +1,556 @@
+/*
+ * File: journal.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the progress journal of multi-lookup -j.
+ *      The per name work is a slot push when a name is read and a
+ *      flag plus watermark advance when its result is written, all in
+ *      memory. Only checkpoints touch the journal file, with one
+ *      write() each.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "journal.h"
+
+#define HEADER_SIZE 8
+#define RECORD_OVERHEAD 9   /* u8 type, u32 length, u32 checksum */
+
+/* Growable output buffer for one checkpoint */
+typedef struct jbuf_s{
+    unsigned char* data;
+    size_t len;
+    size_t cap;
+    size_t recStart;        /* offset of the open record */
+    bool failed;
+} jbuf;
+
+static uint32_t fnv1a(const unsigned char* p, size_t len){
+    uint32_t h = 2166136261u;
+    size_t i;
+
+    for(i=0; i<len; i++){
+	h ^= p[i];
+	h *= 16777619u;
+    }
+    return h;
+}
+
+static void put(jbuf* b, const void* p, size_t n){
+    if(b->failed){
+	return;
+    }
+    if(b->len + n > b->cap){
+	size_t cap = b->cap ? b->cap * 2 : 4096;
+	unsigned char* data;
+	while(cap < b->len + n){
+	    cap *= 2;
+	}
+	data = realloc(b->data, cap);
+	if(!data){
+	    b->failed = true;
+	    return;
+	}
+	b->data = data;
+	b->cap = cap;
+    }
+    memcpy(b->data + b->len, p, n);
+    b->len += n;
+}
+
+static void put32(jbuf* b, uint32_t v){
+    put(b, &v, sizeof(v));
+}
+
+static void put64(jbuf* b, uint64_t v){
+    put(b, &v, sizeof(v));
+}
+
+static void begin_record(jbuf* b, uint8_t type){
+    b->recStart = b->len;
+    put(b, &type, 1);
+    put32(b, 0);            /* length, filled in by end_record */
+}
+
+static void end_record(jbuf* b){
+    uint32_t len;
+
+    if(b->failed){
+	return;
+    }
+    len = b->len - b->recStart - 5;
+    memcpy(b->data + b->recStart + 1, &len, sizeof(len));
+    put32(b, fnv1a(b->data + b->recStart + 5, len));
+}
+
+static void now(struct timespec* ts){
+    clock_gettime(CLOCK_MONOTONIC, ts);
+}
+
+/* Sort paths once so records from earlier runs map back by name */
+typedef struct path_index_s{
+    const char* path;
+    size_t id;
+} path_index;
+
+static int cmp_path(const void* a, const void* b){
+    return strcmp(((const path_index*)a)->path, ((const path_index*)b)->path);
+}
+
+static size_t find_path(const path_index* idx, size_t n, const char* path,
+			size_t len){
+    size_t lo = 0;
+    size_t hi = n;
+
+    while(lo < hi){
+	size_t mid = lo + (hi - lo) / 2;
+	int c = strncmp(idx[mid].path, path, len);
+	if(c == 0 && idx[mid].path[len] != '\0'){
+	    c = 1;
+	}
+	if(c == 0){
+	    return idx[mid].id;
+	}
+	if(c < 0){
+	    lo = mid + 1;
+	}
+	else{
+	    hi = mid;
+	}
+    }
+    return SIZE_MAX;
+}
+
+static uint32_t get32(const unsigned char* p){
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t get64(const unsigned char* p){
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* Apply one checkpoint record. Returns false if it is malformed. */
+static bool replay_ckpt(journal* j, const unsigned char* p, size_t len,
+			const size_t* idmap, size_t nidmap, uint64_t* outputSize){
+    size_t pos = 12;
+    uint32_t count;
+    uint32_t k;
+
+    if(len < 12){
+	return false;
+    }
+    *outputSize = get64(p);
+    count = get32(p + 8);
+    for(k=0; k<count; k++){
+	uint32_t oldId;
+	uint32_t nskip;
+	size_t id;
+	journal_file* f;
+
+	if(pos + 24 > len){
+	    return false;
+	}
+	oldId = get32(p + pos);
+	nskip = get32(p + pos + 20);
+	if(pos + 24 + (size_t) nskip * 8 > len){
+	    return false;
+	}
+	id = oldId < nidmap ? idmap[oldId] : SIZE_MAX;
+	if(id != SIZE_MAX){
+	    f = &j->files[id];
+	    f->doneSeq = get64(p + pos + 4);
+	    f->doneOff = get64(p + pos + 12);
+	    free(f->skip);
+	    f->skip = NULL;
+	    f->nskip = nskip;
+	    if(nskip){
+		f->skip = malloc(nskip * sizeof(*f->skip));
+		if(!f->skip){
+		    return false;
+		}
+		memcpy(f->skip, p + pos + 24, nskip * sizeof(*f->skip));
+	    }
+	}
+	pos += 24 + (size_t) nskip * 8;
+    }
+    return true;
+}
+
+/* Read back an existing journal. Returns the length of its valid
+ * prefix, or 0 if it is not a journal at all. */
+static size_t replay(journal* j, const unsigned char* data, size_t size,
+		     bool* resumed, uint64_t* outputSize){
+    path_index* idx;
+    size_t* idmap = NULL;
+    size_t nidmap = 0;
+    size_t pos;
+    size_t i;
+
+    if(size < HEADER_SIZE || memcmp(data, JOURNAL_MAGIC, HEADER_SIZE)){
+	return 0;
+    }
+    idx = malloc((j->nfiles ? j->nfiles : 1) * sizeof(*idx));
+    if(!idx){
+	return 0;
+    }
+    for(i=0; i<j->nfiles; i++){
+	idx[i].path = j->files[i].path;
+	idx[i].id = i;
+    }
+    qsort(idx, j->nfiles, sizeof(*idx), cmp_path);
+
+    pos = HEADER_SIZE;
+    while(pos + RECORD_OVERHEAD <= size){
+	uint8_t type = data[pos];
+	uint32_t len = get32(data + pos + 1);
+	const unsigned char* p = data + pos + 5;
+
+	if(len > size - pos - RECORD_OVERHEAD ||
+	   get32(p + len) != fnv1a(p, len)){
+	    break;      /* torn or corrupt tail */
+	}
+	if(type == JOURNAL_REC_FILE && len >= 4){
+	    uint32_t oldId = get32(p);
+	    if(oldId >= nidmap){
+		size_t n = nidmap ? nidmap : 64;
+		size_t* more;
+		while(n <= oldId){
+		    n *= 2;
+		}
+		more = realloc(idmap, n * sizeof(*idmap));
+		if(!more){
+		    break;
+		}
+		for(i=nidmap; i<n; i++){
+		    more[i] = SIZE_MAX;
+		}
+		idmap = more;
+		nidmap = n;
+	    }
+	    idmap[oldId] = find_path(idx, j->nfiles, (const char*)(p + 4), len - 4);
+	}
+	else if(type == JOURNAL_REC_CKPT){
+	    if(!replay_ckpt(j, p, len, idmap, nidmap, outputSize)){
+		break;
+	    }
+	    *resumed = true;
+	}
+	else if(type == JOURNAL_REC_DONE && len >= 4){
+	    uint32_t oldId = get32(p);
+	    if(oldId < nidmap && idmap[oldId] != SIZE_MAX){
+		j->files[idmap[oldId]].finished = true;
+	    }
+	}
+	pos += RECORD_OVERHEAD + len;
+    }
+
+    free(idx);
+    free(idmap);
+    return pos;
+}
+
+int journal_open(journal* j, const char* path, char* const* paths,
+		 size_t npaths, bool* resumed, uint64_t* outputSize){
+    struct stat st;
+    unsigned char* data = NULL;
+    size_t valid = 0;
+    size_t i;
+
+    memset(j, 0, sizeof(*j));
+    *resumed = false;
+    *outputSize = 0;
+    pthread_mutex_init(&j->lock, NULL);
+    now(&j->lastCkpt);
+
+    j->nfiles = npaths;
+    j->files = calloc(npaths ? npaths : 1, sizeof(*j->files));
+    if(!j->files){
+	perror("Error on journal Malloc");
+	return JOURNAL_FAILURE;
+    }
+    for(i=0; i<npaths; i++){
+	j->files[i].id = i;
+	j->files[i].path = strdup(paths[i]);
+	if(!j->files[i].path){
+	    perror("Error on journal Malloc");
+	    return JOURNAL_FAILURE;
+	}
+    }
+
+    j->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if(j->fd < 0 || fstat(j->fd, &st)){
+	perror("Error opening journal");
+	return JOURNAL_FAILURE;
+    }
+
+    if(st.st_size > 0){
+	data = malloc(st.st_size);
+	if(!data || pread(j->fd, data, st.st_size, 0) != st.st_size){
+	    perror("Error reading journal");
+	    free(data);
+	    return JOURNAL_FAILURE;
+	}
+	valid = replay(j, data, st.st_size, resumed, outputSize);
+	free(data);
+	if(valid == 0){
+	    /* never overwrite something that is not ours */
+	    fprintf(stderr, "Not a multi-lookup journal: %s\n", path);
+	    return JOURNAL_FAILURE;
+	}
+    }
+
+    if(valid == 0){
+	/* new journal */
+	if(ftruncate(j->fd, 0) ||
+	   pwrite(j->fd, JOURNAL_MAGIC, HEADER_SIZE, 0) != HEADER_SIZE){
+	    perror("Error creating journal");
+	    return JOURNAL_FAILURE;
+	}
+	valid = HEADER_SIZE;
+    }
+    else if(valid < (size_t) st.st_size && ftruncate(j->fd, valid)){
+	perror("Error truncating journal");
+	return JOURNAL_FAILURE;
+    }
+    if(lseek(j->fd, valid, SEEK_SET) < 0){
+	perror("Error seeking journal");
+	return JOURNAL_FAILURE;
+    }
+
+    return JOURNAL_SUCCESS;
+}
+
+journal_file* journal_start(journal* j, size_t id, uint64_t* offset){
+    journal_file* f = &j->files[id];
+
+    pthread_mutex_lock(&j->lock);
+    if(f->finished){
+	pthread_mutex_unlock(&j->lock);
+	return NULL;
+    }
+    f->nextSeq = f->doneSeq;
+    f->winHead = 0;
+    f->winLen = 0;
+    f->skipPos = 0;
+    *offset = f->doneOff;
+    pthread_mutex_unlock(&j->lock);
+
+    return f;
+}
+
+/* Move the watermark past every finished slot at the front */
+static void advance(journal_file* f){
+    while(f->winLen > 0 && f->win[f->winHead].done){
+	f->doneOff = f->win[f->winHead].endOff;
+	f->doneSeq++;
+	f->winHead = (f->winHead + 1) & (f->winCap - 1);
+	f->winLen--;
+    }
+    if(f->eof && f->winLen == 0){
+	f->finished = true;
+    }
+    f->dirty = true;
+}
+
+static bool grow_window(journal_file* f){
+    size_t cap = f->winCap ? f->winCap * 2 : 64;
+    journal_slot* win = malloc(cap * sizeof(*win));
+    size_t i;
+
+    if(!win){
+	return false;
+    }
+    for(i=0; i<f->winLen; i++){
+	win[i] = f->win[(f->winHead + i) & (f->winCap - 1)];
+    }
+    free(f->win);
+    f->win = win;
+    f->winCap = cap;
+    f->winHead = 0;
+    return true;
+}
+
+bool journal_next(journal* j, journal_file* f, uint64_t endOff,
+		  journal_ticket* t){
+    journal_slot* slot;
+    bool skip;
+
+    pthread_mutex_lock(&j->lock);
+    t->jf = f;
+    t->seq = f->nextSeq++;
+
+    while(f->skipPos < f->nskip && f->skip[f->skipPos] < t->seq){
+	f->skipPos++;
+    }
+    skip = f->skipPos < f->nskip && f->skip[f->skipPos] == t->seq;
+
+    if(f->winLen == f->winCap && !grow_window(f)){
+	/* slots are found by sequence number, a missing one would
+	 * corrupt the watermark; stop and let a rerun resume from the
+	 * last checkpoint instead */
+	perror("Error on journal Malloc");
+	exit(EXIT_FAILURE);
+    }
+    slot = &f->win[(f->winHead + f->winLen) & (f->winCap - 1)];
+    slot->endOff = endOff;
+    slot->done = skip;
+    f->winLen++;
+    if(skip){
+	advance(f);
+    }
+    pthread_mutex_unlock(&j->lock);
+
+    return !skip;
+}
+
+void journal_eof(journal* j, journal_file* f){
+    pthread_mutex_lock(&j->lock);
+    f->eof = true;
+    advance(f);
+    pthread_mutex_unlock(&j->lock);
+}
+
+bool journal_done(journal* j, const journal_ticket* t){
+    journal_file* f = t->jf;
+    bool due;
+
+    pthread_mutex_lock(&j->lock);
+    f->win[(f->winHead + (t->seq - f->doneSeq)) & (f->winCap - 1)].done = true;
+    advance(f);
+    j->sinceCkpt++;
+    due = false;
+    /* reading the clock on every name would cost more than the rest */
+    if((j->sinceCkpt & 63) == 0){
+	struct timespec ts;
+	now(&ts);
+	due = (ts.tv_sec - j->lastCkpt.tv_sec) * 1000
+	    + (ts.tv_nsec - j->lastCkpt.tv_nsec) / 1000000 >= JOURNAL_INTERVAL_MS;
+    }
+    pthread_mutex_unlock(&j->lock);
+
+    return due;
+}
+
+int journal_checkpoint(journal* j, uint64_t outputSize){
+    jbuf b;
+    size_t countAt;
+    uint32_t count = 0;
+    size_t i;
+    size_t k;
+    ssize_t n;
+    size_t off = 0;
+    int rv = JOURNAL_SUCCESS;
+
+    memset(&b, 0, sizeof(b));
+    pthread_mutex_lock(&j->lock);
+
+    /* name the files this checkpoint mentions for the first time */
+    for(i=0; i<j->nfiles; i++){
+	journal_file* f = &j->files[i];
+	if(f->dirty && !f->recorded){
+	    begin_record(&b, JOURNAL_REC_FILE);
+	    put32(&b, f->id);
+	    put(&b, f->path, strlen(f->path));
+	    end_record(&b);
+	    f->recorded = true;
+	}
+    }
+    for(i=0; i<j->nfiles; i++){
+	journal_file* f = &j->files[i];
+	if(f->dirty && f->finished){
+	    begin_record(&b, JOURNAL_REC_DONE);
+	    put32(&b, f->id);
+	    end_record(&b);
+	}
+    }
+
+    begin_record(&b, JOURNAL_REC_CKPT);
+    put64(&b, outputSize);
+    countAt = b.len;
+    put32(&b, 0);
+    for(i=0; i<j->nfiles; i++){
+	journal_file* f = &j->files[i];
+	uint32_t nskip = 0;
+	if(!f->dirty){
+	    continue;
+	}
+	f->dirty = false;
+	if(f->finished){
+	    continue;
+	}
+	for(k=0; k<f->winLen; k++){
+	    nskip += f->win[(f->winHead + k) & (f->winCap - 1)].done;
+	}
+	put32(&b, f->id);
+	put64(&b, f->doneSeq);
+	put64(&b, f->doneOff);
+	put32(&b, nskip);
+	for(k=0; k<f->winLen; k++){
+	    if(f->win[(f->winHead + k) & (f->winCap - 1)].done){
+		put64(&b, f->doneSeq + k);
+	    }
+	}
+	count++;
+    }
+    if(!b.failed){
+	memcpy(b.data + countAt, &count, sizeof(count));
+    }
+    end_record(&b);
+
+    j->sinceCkpt = 0;
+    now(&j->lastCkpt);
+    pthread_mutex_unlock(&j->lock);
+
+    if(b.failed){
+	fprintf(stderr, "Error on journal Malloc\n");
+	return JOURNAL_FAILURE;
+    }
+    while(off < b.len){
+	n = write(j->fd, b.data + off, b.len - off);
+	if(n < 0){
+	    if(errno == EINTR){
+		continue;
+	    }
+	    perror("Error writing journal");
+	    rv = JOURNAL_FAILURE;
+	    break;
+	}
+	off += n;
+    }
+    free(b.data);
+
+    return rv;
+}
+
+int journal_close(journal* j, uint64_t outputSize){
+    int rv = journal_checkpoint(j, outputSize);
+    size_t i;
+
+    if(fsync(j->fd)){
+	perror("Error syncing journal");
+	rv = JOURNAL_FAILURE;
+    }
+    close(j->fd);
+    for(i=0; i<j->nfiles; i++){
+	free(j->files[i].path);
+	free(j->files[i].win);
+	free(j->files[i].skip);
+    }
+    free(j->files);
+    pthread_mutex_destroy(&j->lock);
+
+    return rv;
+}
@@ -0,0 +1,132 @@
+/*
+ * File: journal.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the progress journal of
+ *      multi-lookup -j. Names are numbered per input file in the order
+ *      they are read. Results complete out of order, so for every
+ *      file the journal keeps a watermark: names below doneSeq are
+ *      all written, and doneOff is where reading resumes. Names past
+ *      the watermark that are already written are kept too, so a
+ *      resumed run skips them instead of writing them twice.
+ *
+ *      Journal file layout, appended to and never rewritten:
+ *        header        JOURNAL_MAGIC, 8 bytes
+ *        records       u8 type, u32 payload length, payload,
+ *                      u32 FNV-1a of the payload
+ *      JOURNAL_REC_FILE  u32 id, path bytes
+ *      JOURNAL_REC_CKPT  u64 output size, u32 count, then per file:
+ *                        u32 id, u64 doneSeq, u64 doneOff,
+ *                        u32 nskip, u64 skip[nskip]
+ *      JOURNAL_REC_DONE  u32 id
+ *      A checkpoint only lists files that changed since the one
+ *      before. A torn record at the end is cut off on resume.
+ *
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#define JOURNAL_FAILURE -1
+#define JOURNAL_SUCCESS 0
+
+#define JOURNAL_MAGIC "MLJRN01"
+#define JOURNAL_REC_FILE 1
+#define JOURNAL_REC_CKPT 2
+#define JOURNAL_REC_DONE 3
+
+/* checkpoint this often. Each one syncs the output file, so going
+ * by time rather than by count keeps the cost flat at any rate. */
+#define JOURNAL_INTERVAL_MS 1000
+
+/* A name read but not yet below the watermark */
+typedef struct journal_slot_s{
+    uint64_t endOff;        /* input offset just past the name */
+    bool done;
+} journal_slot;
+
+typedef struct journal_file_s{
+    uint32_t id;
+    char* path;             /* own copy, the caller's may go first */
+    bool recorded;          /* FILE record written */
+    bool dirty;             /* changed since the last checkpoint */
+    bool eof;               /* producer read the whole file */
+    bool finished;          /* eof and every name written */
+    uint64_t nextSeq;       /* number for the next name read */
+    uint64_t doneSeq;       /* names below this are all written */
+    uint64_t doneOff;
+    journal_slot* win;      /* ring, slot for seq at (seq - doneSeq) */
+    size_t winCap;          /* power of two */
+    size_t winHead;
+    size_t winLen;
+    uint64_t* skip;         /* resume: written past the watermark */
+    size_t nskip;
+    size_t skipPos;
+} journal_file;
+
+/* Which file and name a result belongs to */
+typedef struct journal_ticket_s{
+    journal_file* jf;
+    uint64_t seq;
+} journal_ticket;
+
+typedef struct journal_s{
+    int fd;
+    pthread_mutex_t lock;
+    journal_file* files;    /* indexed by id, the work list order */
+    size_t nfiles;
+    unsigned long sinceCkpt;
+    struct timespec lastCkpt;
+} journal;
+
+/* Function to open or create the journal at path for the given
+ * input files. If the journal holds progress from an earlier run,
+ * *resumed is set and *outputSize is how much of the output file
+ * that progress accounts for. The paths are copied.
+ * Returns JOURNAL_SUCCESS or JOURNAL_FAILURE
+ */
+int journal_open(journal* j, const char* path, char* const* paths,
+		 size_t npaths, bool* resumed, uint64_t* outputSize);
+
+/* Function for a producer starting file id
+ * Returns the file, with *offset where reading resumes, or NULL if
+ * the file was already finished
+ */
+journal_file* journal_start(journal* j, size_t id, uint64_t* offset);
+
+/* Function to number the next name read from jf, which ends at
+ * input offset endOff
+ * Returns false if an earlier run already wrote its result
+ */
+bool journal_next(journal* j, journal_file* jf, uint64_t endOff,
+		  journal_ticket* t);
+
+/* Function for a producer that reached the end of jf */
+void journal_eof(journal* j, journal_file* jf);
+
+/* Function to record that the result for t is in the output. Call it
+ * with the output locked, right after writing the result.
+ * Returns true when a checkpoint is due
+ */
+bool journal_done(journal* j, const journal_ticket* t);
+
+/* Function to append a checkpoint. The caller holds the output lock
+ * and has flushed it, outputSize is its size.
+ * Returns JOURNAL_SUCCESS or JOURNAL_FAILURE
+ */
+int journal_checkpoint(journal* j, uint64_t outputSize);
+
+/* Function to write a last checkpoint and close the journal
+ * Returns JOURNAL_SUCCESS or JOURNAL_FAILURE
+ */
+int journal_close(journal* j, uint64_t outputSize);
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * File: lookup-load.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Load generator for the multi-lookup daemon. Each connection
+ *      thread sends every name of the input file as one pipelined
+ *      batch, round after round, and the totals are reported as
+ *      answers per second plus batch latency.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "lookupclient.h"
+
+#define MINARGS 3
+#define USAGE "<socketPath> <inputFilePath> [connections] [rounds]"
+#define INPUTFS "%1024s"
+#define SBUFSIZE 1025
+
+typedef struct {
+    const char* path;
+    char** names;
+    long nnames;
+    int rounds;
+    long answers;
+    double maxBatch;    /* seconds */
+    double sumBatch;
+    int failed;
+} load_arg_t;
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* load_thread(void* a){
+    load_arg_t* args = a;
+    lookupclient c;
+    int r;
+
+    if(lookupclient_open(&c, args->path) == LOOKUPCLIENT_FAILURE){
+	args->failed = 1;
+	return NULL;
+    }
+    for(r=0; r<args->rounds; r++){
+	double start = now();
+	long got = lookupclient_batch(&c, args->names, args->nnames, NULL, NULL);
+	double took = now() - start;
+	if(got == LOOKUPCLIENT_FAILURE){
+	    args->failed = 1;
+	    break;
+	}
+	args->answers += got;
+	args->sumBatch += took;
+	if(took > args->maxBatch){
+	    args->maxBatch = took;
+	}
+    }
+    lookupclient_close(&c);
+    return NULL;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Local Vars */
+    FILE* inputfp = NULL;
+    char hostname[SBUFSIZE];
+    char** names = NULL;
+    long nnames = 0;
+    long cap = 0;
+    int conns = 4;
+    int rounds = 10;
+    long total = 0;
+    double maxBatch = 0;
+    double sumBatch = 0;
+    double start;
+    double elapsed;
+    int failed = 0;
+    int i;
+
+    /* Check Arguments */
+    if(argc < MINARGS){
+	fprintf(stderr, "Not enough arguments: %d\n", (argc - 1));
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	return EXIT_FAILURE;
+    }
+    if(argc > 3){
+	conns = atoi(argv[3]);
+    }
+    if(argc > 4){
+	rounds = atoi(argv[4]);
+    }
+    if(conns < 1 || rounds < 1){
+	fprintf(stderr, "Bad connections or rounds value\n");
+	return EXIT_FAILURE;
+    }
+
+    /* Load names */
+    inputfp = fopen(argv[2], "r");
+    if(!inputfp){
+	perror("Error Opening Input File");
+	return EXIT_FAILURE;
+    }
+    while(fscanf(inputfp, INPUTFS, hostname) > 0){
+	if(nnames == cap){
+	    cap = cap ? cap * 2 : 1024;
+	    names = realloc(names, cap * sizeof(*names));
+	    if(!names){
+		perror("Error on load Malloc");
+		return EXIT_FAILURE;
+	    }
+	}
+	names[nnames++] = strdup(hostname);
+    }
+    fclose(inputfp);
+
+    /* Run connections */
+    pthread_t threads[conns];
+    load_arg_t args[conns];
+    start = now();
+    for(i=0; i<conns; i++){
+	memset(&args[i], 0, sizeof(args[i]));
+	args[i].path = argv[1];
+	args[i].names = names;
+	args[i].nnames = nnames;
+	args[i].rounds = rounds;
+	if(pthread_create(&threads[i], NULL, load_thread, &args[i])){
+	    fprintf(stderr, "Error making load thread\n");
+	    return EXIT_FAILURE;
+	}
+    }
+    for(i=0; i<conns; i++){
+	pthread_join(threads[i], NULL);
+	total += args[i].answers;
+	sumBatch += args[i].sumBatch;
+	failed += args[i].failed;
+	if(args[i].maxBatch > maxBatch){
+	    maxBatch = args[i].maxBatch;
+	}
+    }
+    elapsed = now() - start;
+
+    /* Report */
+    fprintf(stdout, "connections=%d rounds=%d names=%ld\n",
+	    conns, rounds, nnames);
+    fprintf(stdout, "answers=%ld elapsed=%.3fs rate=%.0f/s\n",
+	    total, elapsed, total / elapsed);
+    fprintf(stdout, "batch latency mean=%.3fms max=%.3fms\n",
+	    1000 * sumBatch / ((double)conns * rounds), 1000 * maxBatch);
+    if(failed){
+	fprintf(stderr, "%d connection(s) failed\n", failed);
+    }
+
+    for(i=0; i<nnames; i++){
+	free(names[i]);
+    }
+    free(names);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+ * File: lookupclient.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the client library for the multi-lookup
+ *      daemon.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "lookupclient.h"
+
+int lookupclient_open(lookupclient* c, const char* path){
+    struct sockaddr_un addr;
+
+    if(strlen(path) >= sizeof(addr.sun_path)){
+	fprintf(stderr, "Socket path too long: %s\n", path);
+	return LOOKUPCLIENT_FAILURE;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    c->rlen = 0;
+    c->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(c->fd < 0){
+	perror("Error creating client socket");
+	return LOOKUPCLIENT_FAILURE;
+    }
+    if(connect(c->fd, (struct sockaddr*)&addr, sizeof(addr))){
+	perror("Error connecting to lookup daemon");
+	close(c->fd);
+	return LOOKUPCLIENT_FAILURE;
+    }
+    return LOOKUPCLIENT_SUCCESS;
+}
+
+/* Fill out with as many whole names as fit, from *next on */
+static size_t stage_names(char* out, size_t size, char* const* names,
+			  long n, long* next, long* staged){
+    size_t used = 0;
+
+    while(*next < n){
+	size_t len = strlen(names[*next]);
+	if(len == 0){
+	    (*next)++;
+	    continue;
+	}
+	if(len + 1 > size){
+	    /* can never be sent, the daemon caps names anyway */
+	    (*next)++;
+	    continue;
+	}
+	if(used + len + 1 > size){
+	    break;
+	}
+	memcpy(out + used, names[*next], len);
+	used += len;
+	out[used++] = '\n';
+	(*next)++;
+	(*staged)++;
+    }
+    return used;
+}
+
+/* Read what is there and hand complete lines to cb
+ * Returns answers seen, or LOOKUPCLIENT_FAILURE */
+static long read_answers(lookupclient* c, lookupclient_cb cb, void* arg){
+    ssize_t r;
+    size_t start = 0;
+    size_t i;
+    long answers = 0;
+
+    r = recv(c->fd, c->rbuf + c->rlen, sizeof(c->rbuf) - c->rlen - 1, 0);
+    if(r <= 0){
+	if(r < 0 && errno == EINTR){
+	    return 0;
+	}
+	if(r == 0){
+	    fprintf(stderr, "Lookup daemon closed the connection\n");
+	}
+	else{
+	    perror("Error reading from lookup daemon");
+	}
+	return LOOKUPCLIENT_FAILURE;
+    }
+    c->rlen += r;
+
+    for(i=0; i<c->rlen; i++){
+	if(c->rbuf[i] == '\n'){
+	    c->rbuf[i] = '\0';
+	    if(cb){
+		cb(c->rbuf + start, arg);
+	    }
+	    answers++;
+	    start = i + 1;
+	}
+    }
+    memmove(c->rbuf, c->rbuf + start, c->rlen - start);
+    c->rlen -= start;
+    return answers;
+}
+
+long lookupclient_batch(lookupclient* c, char* const* names, long n,
+			lookupclient_cb cb, void* arg){
+    char wbuf[LOOKUPCLIENT_BUFSIZE];
+    size_t wlen = 0;
+    size_t woff = 0;
+    long next = 0;
+    long sent = 0;
+    long answered = 0;
+    struct pollfd pfd;
+
+    pfd.fd = c->fd;
+    for(;;){
+	if(woff == wlen && next < n){
+	    wlen = stage_names(wbuf, sizeof(wbuf), names, n, &next, &sent);
+	    woff = 0;
+	}
+	if(woff == wlen && next >= n && answered >= sent){
+	    break;
+	}
+
+	pfd.events = POLLIN | (woff < wlen ? POLLOUT : 0);
+	if(poll(&pfd, 1, -1) < 0){
+	    if(errno == EINTR){
+		continue;
+	    }
+	    perror("Error polling lookup daemon");
+	    return LOOKUPCLIENT_FAILURE;
+	}
+
+	if(pfd.revents & POLLOUT){
+	    ssize_t w = send(c->fd, wbuf + woff, wlen - woff,
+			     MSG_DONTWAIT | MSG_NOSIGNAL);
+	    if(w < 0 && errno != EAGAIN && errno != EINTR){
+		perror("Error writing to lookup daemon");
+		return LOOKUPCLIENT_FAILURE;
+	    }
+	    if(w > 0){
+		woff += w;
+	    }
+	}
+	if(pfd.revents & (POLLIN | POLLHUP | POLLERR)){
+	    long a = read_answers(c, cb, arg);
+	    if(a == LOOKUPCLIENT_FAILURE){
+		return LOOKUPCLIENT_FAILURE;
+	    }
+	    answered += a;
+	}
+    }
+
+    return answered;
+}
+
+void lookupclient_close(lookupclient* c){
+    close(c->fd);
+    c->fd = -1;
+}
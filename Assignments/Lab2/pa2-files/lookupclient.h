@@ -0,0 +1,52 @@
+/*
+ * File: lookupclient.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the client library of the
+ *      multi-lookup daemon (multi-lookup -d). One connection can carry
+ *      any number of batches, each batch is pipelined: names are
+ *      streamed out while answers stream back.
+ *
+ */
+
+#ifndef LOOKUPCLIENT_H
+#define LOOKUPCLIENT_H
+
+#include <stddef.h>
+
+#define LOOKUPCLIENT_FAILURE -1
+#define LOOKUPCLIENT_SUCCESS 0
+
+#define LOOKUPCLIENT_BUFSIZE 65536
+
+/* Called once per answer with "hostname,ip[,ip...]" (no newline).
+ * Answers come in completion order, not request order. */
+typedef void (*lookupclient_cb)(const char* line, void* arg);
+
+typedef struct lookupclient_s{
+    int fd;
+    char rbuf[LOOKUPCLIENT_BUFSIZE];    /* partial answer line */
+    size_t rlen;
+} lookupclient;
+
+/* Function to connect to a daemon listening on path
+ * Returns LOOKUPCLIENT_SUCCESS or LOOKUPCLIENT_FAILURE
+ */
+int lookupclient_open(lookupclient* c, const char* path);
+
+/* Function to resolve n names
+ * Sends and receives at the same time, so batches of any size
+ * cannot deadlock against the daemon's flow control. Empty names
+ * are skipped.
+ * Returns the number of answers passed to cb, or
+ * LOOKUPCLIENT_FAILURE if the connection failed
+ */
+long lookupclient_batch(lookupclient* c, char* const* names, long n,
+			lookupclient_cb cb, void* arg);
+
+/* Function to close the connection */
+void lookupclient_close(lookupclient* c);
+
+#endif
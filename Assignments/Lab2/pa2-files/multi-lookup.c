@@ -1,3 +1,5 @@
+#define _GNU_SOURCE
+
 #include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -5,18 +7,45 @@
 #include <errno.h>
 #include <unistd.h>
 #include <stdbool.h> 
+#include <ctype.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
 
 #include "queue.h"
+#include "shmqueue.h"
+#include "spinwait.h"
+#include "dedup.h"
+#include "resfile.h"
+#include "server.h"
+#include "worklist.h"
+#include "fileio.h"
+#include "journal.h"
+#include "zone.h"
+#include "topology.h"
+#include "extsort.h"
+#include "ratelimit.h"
 #include "util.h"
 #include "multi-lookup.h"
 
-#define MAX_INPUT_FILES 10
+#define DEFAULT_PRODUCER_THREADS 4
+#define MAX_PRODUCER_THREADS 64
 #define MAX_RESOLVER_THREADS 10
 #define MIN_RESOLVER_THREADS 2
 #define MAX_NAME_LENGTH 1025
 #define MAX_IP_LENGTH INET6_ADDRSTRLEN
+// hostname plus every address, comma separated
+#define MAX_RESULT_LENGTH (MAX_NAME_LENGTH + UTIL_MAX_ADDRS * (UTIL_ADDRSTRLEN + 1) + 2)
 #define MINIMUM_ARGS 2
 #define DEBUG 0
+#define INPUTFS "%1024s"
+#define STREAM_BUFSIZE 65536
+#define USAGE "[-a compact|spread|isolate] [-D] [-f text|bin] [-i stdio|uring] [-j journalPath] [-p producers] [-q rate[:burst]] [-Q queueName] [-r]\n" \
+	"       [-S sortMB] [-w block|spin] [-z zoneFile ...] <inputPath> ... <outputFilePath>\n" \
+	"       %s [-a compact|spread|isolate] [-D] [-q rate[:burst]] [-r] [-w block|spin] [-z zoneFile ...] -d <socketPath>\n" \
+	"       %s -s [-a compact|spread|isolate] [-D] [-q rate[:burst]] [-r] [-Q queueName] [-w block|spin] [-z zoneFile ...] [<inputPath|-> ...] <outputFilePath|->"
 
 bool buffer_finished = false;
 
@@ -26,55 +55,493 @@ pthread_mutex_t output_mutex;
 pthread_cond_t empty;
 pthread_cond_t full;
 
-// Thread that reads files that have web addresses on it
-// and pushes them onto a shared buffer 
-void* producer(void* a){
+// how producers and consumers wait on a full/empty buffer
+spinwait producer_spin;
+spinwait consumer_spin;
 
-	if (DEBUG) {
-		fprintf((stderr), "starting producer thread: \n");
+// readiness checks for spinwait_until, called with buffer_mutex held
+static bool queue_has_room(void* q)
+{
+	return !queue_is_full((queue*) q);
+}
+
+static bool queue_has_work(void* q)
+{
+	return !queue_is_empty((queue*) q) || buffer_finished;
+}
+
+// Format "hostname,ip,ip,...". This is the only place addresses are
+// turned into text, everything before it carries them in binary.
+// Returns the length without the terminating NUL.
+static int format_result(char* line, const char* hostname, const ip_list_t* ips)
+{
+	size_t len = strlen(hostname);
+	int i;
+
+	memcpy(line, hostname, len);
+	line[len++] = ',';
+	for (i = 0; i < ips->naddrs; i++) {
+		len += ip_format(&ips->addrs[i], line + len);
+		line[len++] = ',';
+	}
+	// drop the trailing comma, a failed lookup keeps "hostname,"
+	if (ips->naddrs > 0) {
+		len--;
+	}
+	line[len] = '\0';
+	return len;
+}
+
+// Flush the output and record progress up to here, with output_mutex
+// held. The output reaches the disk before the journal says it has.
+static void checkpoint_output(output_t* out)
+{
+	if (fflush(out->outputfp) || fdatasync(fileno(out->outputfp))) {
+		perror("error flushing output for checkpoint");
+		return;
+	}
+	if (journal_checkpoint(out->journal, out->written) == JOURNAL_FAILURE) {
+		fprintf(stderr, "error writing checkpoint\n");
+	}
+}
+
+// Reverse (-r) result line, "ip,name", or "ip," when there is no name
+static int format_reverse(char* line, const char* ip, const char* name)
+{
+	return snprintf(line, MAX_RESULT_LENGTH - 1, "%s,%s", ip, name);
+}
+
+// Hand one text line to the output. Lines either go to the shared
+// output file, or onto a shared memory queue read by an aggregator.
+// line has room for a newline after its len chars. hostname is what
+// it answers, for error messages, and ticket its input name with -j.
+static void write_line(output_t* out, char* line, int len, const char* hostname,
+		       const journal_ticket* ticket)
+{
+	if (out->outputq) {
+		// shared queue does its own locking across processes
+		if (shmqueue_push(out->outputq, line) == QUEUE_FAILURE) {
+			fprintf(stderr, "result too long for shared queue: %s\n", hostname);
+		}
+		return;
+	}
+
+	if (out->sorter) {
+		// kept for the sort -u at the end instead of written now
+		pthread_mutex_lock(&output_mutex);
+		if (extsort_add(out->sorter, line, len) == EXTSORT_FAILURE) {
+			fprintf(stderr, "error sorting result: %s\n", hostname);
+		}
+		pthread_mutex_unlock(&output_mutex);
+		return;
+	}
+
+	line[len++] = '\n';
+	if (out->io) {
+		// copied into a write buffer, the I/O thread writes it out
+		if (fileio_append(out->io, line, len) == FILEIO_FAILURE) {
+			fprintf(stderr, "error writing result: %s\n", hostname);
+		}
+		return;
+	}
+
+	// Line is ready before taking the lock, so the critical
+	// section is just the copy into the stdio buffer
+	pthread_mutex_lock(&output_mutex);
+	fwrite(line, 1, len, out->outputfp);
+	if (out->journal && ticket) {
+		// marked done under the same lock, so a checkpoint never
+		// counts a result that is not in the output yet
+		out->written += len;
+		if (journal_done(out->journal, ticket)) {
+			checkpoint_output(out);
+		}
+	}
+	pthread_mutex_unlock(&output_mutex);
+}
+
+// Hand one result to the output, ticket says which input name it
+// answers, with -j.
+static void write_result(output_t* out, const char* hostname, const ip_list_t* ips,
+			 const journal_ticket* ticket)
+{
+	if (out->bin) {
+		// binary records keep the addresses as they are
+		pthread_mutex_lock(&output_mutex);
+		if (resfile_append(out->bin, hostname, ips) == RESFILE_FAILURE) {
+			fprintf(stderr, "error writing result: %s\n", hostname);
+		}
+		pthread_mutex_unlock(&output_mutex);
+		return;
+	}
+
+	char line[MAX_RESULT_LENGTH];
+	int len = format_result(line, hostname, ips);
+	write_line(out, line, len, hostname, ticket);
+}
+
+// Deliver a result to whoever asked for it: a daemon client, or the output
+static void deliver(output_t* out, server_conn* conn, const char* hostname, const ip_list_t* ips,
+		    const journal_ticket* ticket)
+{
+	if (conn) {
+		char line[MAX_RESULT_LENGTH];
+		int len = format_result(line, hostname, ips);
+		line[len++] = '\n';
+		server_reply(conn, line, len);
+		return;
+	}
+	write_result(out, hostname, ips, ticket);
+}
+
+// Same for a -r result, the name ip maps back to
+static void deliver_reverse(output_t* out, server_conn* conn, const char* ip, const char* name,
+			    const journal_ticket* ticket)
+{
+	char line[MAX_RESULT_LENGTH];
+	int len = format_reverse(line, ip, name);
+	if (conn) {
+		line[len++] = '\n';
+		server_reply(conn, line, len);
+		return;
+	}
+	write_line(out, line, len, ip, ticket);
+}
+
+// Push one request onto the shared buffer, waiting while it is full
+static void push_request(queue* buffer, lookup_request_t* request)
+{
+	pthread_mutex_lock(&buffer_mutex);
+	if (queue_is_full(buffer)) {
+		// spin a little before parking, a consumer is likely about to pop
+		pthread_mutex_unlock(&buffer_mutex);
+		if (!spinwait_until(&producer_spin, &buffer_mutex, queue_has_room, buffer)) {
+			pthread_mutex_lock(&buffer_mutex);
+		}
+	}
+	// While queue is not full, keep pushing names onto the queue
+	// if queue is full condition wait on the full variable
+	while((queue_push(buffer, request)) == QUEUE_FAILURE) {
+		if (DEBUG) { fprintf(stderr, "queue is full pls hurry\n");}
+		pthread_cond_wait(&full, &buffer_mutex);
+	}
+	pthread_cond_signal(&empty);
+	pthread_mutex_unlock(&buffer_mutex);
+}
+
+// Send one name to the resolvers, or answer it straight away when it
+// is in a -z zone file or -D has already seen it. conn is the daemon
+// client asking, or NULL. ticket is the name's place in the -j
+// journal, or NULL.
+static void submit_name(thread_request_arg_t* args, const char* hostname, server_conn* conn,
+			const journal_ticket* ticket)
+{
+	dedup_entry* entry = NULL;
+	if (args->zones) {
+		// the table never changes once loaded, so no lock and no queue
+		ip_list_t ips;
+		if (zone_lookup(args->zones, hostname, &ips)) {
+			deliver(args->output, conn, hostname, &ips, ticket);
+			return;
+		}
+	}
+	if (args->dedup) {
+		// only the first occurrence of a name goes to the resolvers.
+		// A repeat that has to wait is answered through ctx: the
+		// daemon client, or with -j a copy of the ticket
+		ip_list_t ips;
+		void* ctx = conn;
+		if (ticket) {
+			ctx = malloc(sizeof(*ticket));
+			memcpy(ctx, ticket, sizeof(*ticket));
+		}
+		int rv = dedup_insert(args->dedup, hostname, ctx, &entry, &ips);
+		if (rv == DEDUP_PENDING) {
+			// written by the resolver once the original completes
+			return;
+		}
+		if (ticket) {
+			free(ctx);
+		}
+		if (rv == DEDUP_DONE) {
+			// already resolved, answer it from the recorded result
+			deliver(args->output, conn, hostname, &ips, ticket);
+			return;
+		}
+		// on DEDUP_FAILURE just resolve it again
+	}
+
+	// One reason to dynamically allocate memory is to effectively use the memory of the computer, 
+	// another is to prevent the memory from going out of scope before you are done with it.
+	size_t hostsize = strlen(hostname) + 1;
+	lookup_request_t* request = malloc(sizeof(*request) + hostsize);
+	memcpy(request->hostname, hostname, hostsize); // now point to the host name
+	request->entry = entry;
+	request->conn = conn;
+	request->ticket.jf = NULL;
+	if (ticket) {
+		request->ticket = *ticket;
+	}
+
+	push_request(args->buffer, request);
+	if (DEBUG) { fprintf(stderr, "pushing onto queue: %s\n", hostname); }
+}
+
+// Called by the daemon's event loop for each name a client sends. The
+// loop must never wait on a full buffer, every other client would
+// wait with it, so the name is refused instead and offered again once
+// a resolver makes room. The loop is the only thread pushing in daemon
+// mode, so a buffer with room here still has room in submit_name.
+static int daemon_submit(const char* hostname, server_conn* conn, void* arg)
+{
+	thread_request_arg_t* args = (thread_request_arg_t*) arg;
+	bool room;
+
+	pthread_mutex_lock(&buffer_mutex);
+	room = !queue_is_full(args->buffer);
+	pthread_mutex_unlock(&buffer_mutex);
+	if (!room) {
+		return SERVER_BUSY;
+	}
+	submit_name(args, hostname, conn, NULL);
+	return SERVER_SUCCESS;
+}
+
+// Submit every name in buf. Names are whitespace separated, same as
+// INPUTFS, and one may run across reads: hostname holds its first len
+// chars on the way in, and the unfinished name on the way out.
+// Returns the new len.
+static size_t scan_names(thread_request_arg_t* args, const char* buf, size_t n,
+			 char* hostname, size_t len)
+{
+	size_t i;
+	for (i = 0; i < n; i++) {
+		if (isspace((unsigned char) buf[i])) {
+			if (len > 0) {
+				hostname[len] = '\0';
+				submit_name(args, hostname, NULL, NULL);
+				len = 0;
+			}
+		}
+		else if (len < MAX_NAME_LENGTH - 1) {
+			hostname[len++] = buf[i];
+		}
+	}
+	return len;
+}
+
+// -i uring: parse chunks the I/O thread has already read ahead
+static void produce_file_async(thread_request_arg_t* args, const char* fname)
+{
+	fileio_reader* reader = fileio_open(args->output->io, fname);
+	if (!reader) {
+		char errorstr[MAX_NAME_LENGTH];
+		snprintf(errorstr, sizeof(errorstr), "error opening file %s", fname);
+		perror(errorstr);
+		return;
+	}
+
+	char hostname[MAX_NAME_LENGTH];
+	size_t len = 0;
+	const char* chunk;
+	ssize_t n;
+	while ((n = fileio_read(reader, &chunk)) > 0) {
+		len = scan_names(args, chunk, n, hostname, len);
+	}
+	if (n < 0) {
+		perror(fname);
+	}
+	// a last name without a trailing newline
+	if (len > 0) {
+		hostname[len] = '\0';
+		submit_name(args, hostname, NULL, NULL);
+	}
+
+	fileio_close(reader);
+}
+
+// Read one input file and push its names onto the shared buffer.
+// id is its place on the work list, which the -j journal goes by.
+static void produce_file(thread_request_arg_t* args, const char* fname, size_t id)
+{
+	if (args->output->io) {
+		produce_file_async(args, fname);
+		return;
+	}
+
+	journal* jrn = args->output->journal;
+	journal_file* jf = NULL;
+	uint64_t offset = 0;
+	if (jrn) {
+		// pick up where an earlier run stopped, or skip the file
+		jf = journal_start(jrn, id, &offset);
+		if (!jf) {
+			if (DEBUG) { fprintf(stderr, "already done: %s\n", fname); }
+			return;
+		}
 	}
 
-	// opening file 
-	// thread_request_arg_t is struct, this gives each thread a filename and the buffer
-	thread_request_arg_t* args = (thread_request_arg_t*) a;
 	FILE* input_fp = NULL;
-	if (DEBUG) { fprintf(stderr, "opening input file: %s\n", args->fname); }
-	input_fp = fopen(args->fname, "r");
+	if (DEBUG) { fprintf(stderr, "opening input file: %s\n", fname); }
+	input_fp = fopen(fname, "r");
 	if(!input_fp){
 		// show error if file cannot be opened
 		char errorstr[MAX_NAME_LENGTH];
-		sprintf(errorstr, "error opening file %s", args->fname);
+		snprintf(errorstr, sizeof(errorstr), "error opening file %s", fname);
 		perror(errorstr);
-		return NULL;
+		return;
+	}
+	// read front to back, let the kernel read ahead further
+	posix_fadvise(fileno(input_fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+	if (offset && fseeko(input_fp, offset, SEEK_SET)) {
+		perror(fname);
+		fclose(input_fp);
+		return;
 	}
 
-	// size of what you want to malloc
 	char hostname[MAX_NAME_LENGTH];
-	while(fscanf(input_fp, "%s", hostname) > 0){ // while you have successfully filled more than 0 items of the argument list
-		int hostsize = sizeof(hostname);
-		char* hostpointer = malloc(hostsize);
-		// One reason to dynamically allocate memory is to effectively use the memory of the computer, 
-		// another is to prevent the memory from going out of scope before you are done with it.
-		strncpy(hostpointer, hostname, hostsize); // now point to the host name
-		
-		pthread_mutex_lock(&buffer_mutex);
-		// While queue is not full, keep pushing names onto the queue
-		// if queue is full condition wait on the full variable
-		while((queue_push(args->buffer, hostpointer)) == QUEUE_FAILURE) {
-			if (DEBUG) { fprintf(stderr, "queue is full pls hurry\n");}
-			pthread_cond_wait(&full, &buffer_mutex);
+	if (jf) {
+		// %n counts what each call consumed, far cheaper than ftello
+		int consumed;
+		while (fscanf(input_fp, INPUTFS "%n", hostname, &consumed) > 0) {
+			journal_ticket ticket;
+			offset += consumed;
+			// names an earlier run already wrote are not done again
+			if (journal_next(jrn, jf, offset, &ticket)) {
+				submit_name(args, hostname, NULL, &ticket);
+			}
+		}
+		journal_eof(jrn, jf);
+	}
+	else {
+		while(fscanf(input_fp, INPUTFS, hostname) > 0){ // while you have successfully filled more than 0 items of the argument list
+			submit_name(args, hostname, NULL, NULL);
 		}
-		pthread_cond_signal(&empty);
-		pthread_mutex_unlock(&buffer_mutex);
-        if (DEBUG) { fprintf(stderr, "pushing onto queue: %s\n", hostname); }
 	}
 
 	// close input file
 	fclose(input_fp);
+}
+
+// Thread in the producer pool. Takes input files off the shared work
+// list until it is empty, so each producer has one file open at a
+// time however many files there are
+void* producer(void* a){
+
+	if (DEBUG) {
+		fprintf((stderr), "starting producer thread: \n");
+	}
+
+	// thread_request_arg_t is struct, this gives each thread the work list and the buffer
+	thread_request_arg_t* args = (thread_request_arg_t*) a;
+	const char* fname;
+	const char* next;
+	size_t id;
+
+	while ((fname = worklist_next(args->work, &next, &id)) != NULL) {
+		// get the following file into the page cache while this one is parsed
+		if (next) {
+			worklist_prefetch(next);
+		}
+		produce_file(args, fname, id);
+	}
 
 	return NULL; // exit
 }
 
+// Producer for -s. Reads a pipe, FIFO or stdin ("-") as names arrive.
+// fscanf would sit in read() forever on a quiet stream, so this polls
+// the input together with stopfd, which turns readable once SIGINT or
+// SIGTERM is pending. Memory stays bounded: one read buffer, and the
+// shared buffer blocks this thread when the resolvers fall behind.
+void* stream_producer(void* a)
+{
+	thread_request_arg_t* args = (thread_request_arg_t*) a;
+	int fd = STDIN_FILENO;
+
+	if (strcmp(args->fname, "-")) {
+		// O_NONBLOCK so opening a FIFO does not wait for a writer,
+		// poll below does that instead
+		fd = open(args->fname, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) {
+			char errorstr[MAX_NAME_LENGTH];
+			snprintf(errorstr, sizeof(errorstr), "error opening file %s", args->fname);
+			perror(errorstr);
+			return NULL;
+		}
+	}
+
+	char buf[STREAM_BUFSIZE];
+	char hostname[MAX_NAME_LENGTH];
+	size_t len = 0; // chars of the name being read, it may span reads
+	struct pollfd fds[2];
+	fds[0].fd = fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = args->stopfd;
+	fds[1].events = POLLIN;
+
+	while (1) {
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			perror("error polling input stream");
+			break;
+		}
+		// leave the signal pending so every stream producer sees it
+		if (fds[1].revents) {
+			if (DEBUG) { fprintf(stderr, "stop requested: %s\n", args->fname); }
+			break;
+		}
+		if (!fds[0].revents) {
+			continue;
+		}
+
+		ssize_t n = read(fd, buf, sizeof(buf));
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EINTR) {
+				continue;
+			}
+			perror("error reading input stream");
+			break;
+		}
+		if (n == 0) {
+			break; // EOF, every writer is gone
+		}
+
+		len = scan_names(args, buf, n, hostname, len);
+	}
+
+	// a last name without a trailing newline
+	if (len > 0) {
+		hostname[len] = '\0';
+		submit_name(args, hostname, NULL, NULL);
+	}
+
+	if (fd != STDIN_FILENO) {
+		close(fd);
+	}
+	return NULL;
+}
+
+// Look hostname up into ips, or with ip given (-r) look up the name
+// it maps back to, through the -q rate limit when there is one. A
+// temporary failure (SERVFAIL, REFUSED or no answer upstream) slows
+// the limit down and the query gets another try at the lower rate.
+static int limited_query(ratelimit* limit, const char* hostname, ip_list_t* ips,
+			 const ip_addr_t* ip, char* name, int size)
+{
+	int rc;
+	int tries = 0;
+
+	do {
+		if (limit) { ratelimit_acquire(limit); }
+		rc = ip ? dnsreverse(ip, name, size) : dnslookup_all(hostname, ips);
+		if (limit) { ratelimit_result(limit, rc == UTIL_TRYAGAIN); }
+	} while (limit && rc == UTIL_TRYAGAIN && tries++ < RATELIMIT_RETRIES);
+	return rc;
+}
+
 // Thread that takes items off of the buffer from
 // what the consumer created and does a DNS lookup on them
 void* consumer(void* a)
@@ -85,13 +552,20 @@ void* consumer(void* a)
 	if (DEBUG) { fprintf(stderr, "Starting consumer thread]n"); }
 
 	while(1) {
-		char* hostnamep;
+		lookup_request_t* request;
 		if (DEBUG) { fprintf(stderr, "grabbing hostname from queue\n"); }
 		// if (DEBUG) { fprintf(stderr, "Popping off queue"); }
 		pthread_mutex_lock(&buffer_mutex);
+		if (queue_is_empty(args->rqueue) && !buffer_finished) {
+			// spin a little before parking, a producer is likely about to push
+			pthread_mutex_unlock(&buffer_mutex);
+			if (!spinwait_until(&consumer_spin, &buffer_mutex, queue_has_work, args->rqueue)) {
+				pthread_mutex_lock(&buffer_mutex);
+			}
+		}
 		// while queue is not empty, keep popping off from the queue
 		// if queue empty (NULL) then do one of two things
-		while( (hostnamep = queue_pop(args->rqueue)) == NULL) {
+		while( (request = queue_pop(args->rqueue)) == NULL) {
 			// if buffer is done being added to, just return
 			if (buffer_finished) {
 				pthread_mutex_unlock(&buffer_mutex);
@@ -100,73 +574,423 @@ void* consumer(void* a)
 			// if still running, then wait on the empty signal and unlock buffer
 			pthread_cond_wait(&empty, &buffer_mutex);
 		}
+		// half empty is when a daemon loop holding names back is told
+		bool resume = args->srv && queue_count(args->rqueue) <= args->rqueue->maxSize / 2;
 		// when thread is done popping off queue, unlock buffer mutex
 		pthread_mutex_unlock(&buffer_mutex);
 		// and then signal producer to wake up
 		if (DEBUG) { fprintf(stderr, "wakeup producer!\n"); }
 		pthread_cond_signal(&full);
+		if (resume) {
+			server_resume(args->srv);
+		}
 
 		// If queue is not empty, read a name from queue and look it up
-		char hostname[MAX_NAME_LENGTH];
-		sprintf(hostname, "%s", hostnamep);
-		free(hostnamep);
+		char* hostname = request->hostname;
+
+		if (args->reverse) {
+			// -r: the "hostname" is an address, find its name
+			char name[NI_MAXHOST] = "";
+			ip_addr_t ip;
+			if (ip_parse(hostname, &ip) == UTIL_FAILURE) {
+				fprintf(stderr, "not an IP address: %s\n", hostname);
+			}
+			else if (limited_query(args->limit, NULL, NULL, &ip, name, sizeof(name)) != UTIL_SUCCESS) {
+				fprintf(stderr, "dnsreverse error: %s\n", hostname);
+			}
+			deliver_reverse(args->output, request->conn, hostname, name,
+					request->ticket.jf ? &request->ticket : NULL);
+			free(request);
+			continue;
+		}
 
 		if (DEBUG) { fprintf(stderr, "dns lookup: %s\n", hostname); }
-		char ipstring[INET6_ADDRSTRLEN];
-		// Lookup hostname and get IP string (from lookup.c)
-	    if(dnslookup(hostname, ipstring, sizeof(ipstring))
-	       == UTIL_FAILURE){
+		ip_list_t ips;
+		// Lookup hostname and get every address, still in binary
+	    if(limited_query(args->limit, hostname, &ips, NULL, NULL, 0)
+	       != UTIL_SUCCESS){
 		fprintf(stderr, "dnslookup error: %s\n", hostname);
-		strncpy(ipstring, "", sizeof(ipstring));
 	    } 
 
-	    // When done getting IP string, lock output file mutex,
-	    // write to output file, and unlock output file mutex:
 	    if (DEBUG) { fprintf(stderr, "resolving hostname: %s\n", hostname); }
-	    pthread_mutex_lock(&output_mutex);
-	    fprintf(args->outputfp, "%s,%s\n", hostname, ipstring);
-	    pthread_mutex_unlock(&output_mutex);
+	    deliver(args->output, request->conn, hostname, &ips,
+	    	    request->ticket.jf ? &request->ticket : NULL);
+
+	    // answer the repeats that showed up while this one was in flight
+	    if (request->entry) {
+	    	dedup_waiter* waiters = dedup_complete(args->dedup, request->entry, &ips);
+	    	dedup_waiter* w;
+	    	for (w = waiters; w; w = w->next) {
+	    		if (args->output->journal) {
+	    			// ctx is the repeat's own journal ticket
+	    			deliver(args->output, NULL, w->hostname, &ips, w->ctx);
+	    			free(w->ctx);
+	    			continue;
+	    		}
+	    		deliver(args->output, w->ctx, w->hostname, &ips, NULL);
+	    	}
+	    	dedup_free_waiters(waiters);
+	    }
+	    free(request);
 	} 
 }
 
 int main(int argc, char* argv[]){
 	queue buffer; // shared buffer
 	FILE* outputfp = NULL; // shared output file
-	pthread_t producer_threads[argc-1];
+	shmqueue outputq; // shared memory queue when publishing to an aggregator
+	output_t output; // where resolved names are written
+	dedup_set dedup; // names already seen, with -D
+	resfile_writer bin; // binary output, with -f bin
+	bool use_bin = false;
+	server srv; // unix socket front end, with -d
+	char* socket_path = NULL;
+	bool use_dedup = false;
+	char* queue_name = NULL;
 	pthread_t consumer_threads[MAX_RESOLVER_THREADS];
 	int i; // counter
+	int opt;
 	int buffer_size = QUEUEMAXSIZE; // maxsize for buffer
+	bool spin = false; // spin before parking on a full/empty buffer
+	bool stream = false; // -s, read pipes/FIFOs/stdin until EOF or a signal
+	int pool_size = DEFAULT_PRODUCER_THREADS; // -p, producers sharing the input files
+	int nproducers = 0;
+	worklist work; // input files for the producer pool
+	bool use_uring = false; // -i uring, asynchronous file I/O
+	char* journal_path = NULL; // -j, resumable progress
+	journal jrn;
+	bool resumed = false;
+	uint64_t resume_size = 0; // output bytes the journal accounts for
+	char* zone_paths[argc]; // -z, hosts and zone files to answer from
+	int nzones = 0;
+	zone zones;
+	int placement = TOPOLOGY_NONE; // -a, where threads may run
+	topology topo;
+	int sort_mb = 0; // -S, memory budget for sorting the output
+	bool reverse = false; // -r, inputs are addresses to find names for
+	extsort sorter;
+	char* rate_spec = NULL; // -q, upstream queries per second and burst
+	ratelimit limit;
+	fileio io;
+	int stopfd = -1; // with -s, readable once SIGINT/SIGTERM arrives
+	char* stdin_input[] = { "-" };
 
-	// initialize shared buffer
-	queue_init(&buffer, buffer_size);
+	// Parse options, everything after them is input files (and the output file)
+	while ((opt = getopt(argc, argv, "a:Dd:f:i:j:p:q:Q:rsS:w:z:")) != -1) {
+		switch (opt) {
+		case 'a':
+			// pin threads by cpu topology
+			placement = topology_policy(optarg);
+			if (placement == TOPOLOGY_FAILURE) {
+				fprintf(stderr, "ERROR: unknown placement %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'D':
+			// drop duplicate names before they reach the resolvers
+			use_dedup = true;
+			break;
+		case 'd':
+			// run as a daemon answering clients on a unix socket
+			socket_path = optarg;
+			break;
+		case 'f':
+			// output format
+			if (!strcmp(optarg, "bin")) {
+				use_bin = true;
+			}
+			else if (strcmp(optarg, "text")) {
+				fprintf(stderr, "ERROR: unknown output format %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'i':
+			// how input and output files are read and written
+			if (!strcmp(optarg, "uring")) {
+				use_uring = true;
+			}
+			else if (strcmp(optarg, "stdio")) {
+				fprintf(stderr, "ERROR: unknown I/O method %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'j':
+			// journal progress so an interrupted run can resume
+			journal_path = optarg;
+			break;
+		case 'p':
+			// size of the producer pool
+			pool_size = atoi(optarg);
+			if (pool_size < 1 || pool_size > MAX_PRODUCER_THREADS) {
+				fprintf(stderr, "ERROR: -p takes 1 to %d producers\n", MAX_PRODUCER_THREADS);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'q':
+			// rate limit lookups sent upstream
+			rate_spec = optarg;
+			break;
+		case 'Q':
+			// publish results to an aggregator instead of an output file
+			queue_name = optarg;
+			break;
+		case 'r':
+			// reverse lookups, address to name
+			reverse = true;
+			break;
+		case 's':
+			// streaming input, results are flushed as they come
+			stream = true;
+			break;
+		case 'S':
+			// write the output sorted with duplicates removed
+			sort_mb = atoi(optarg);
+			if (sort_mb < 1) {
+				fprintf(stderr, "ERROR: -S takes a memory budget in MB\n");
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'w':
+			// wait strategy on a full or empty buffer
+			if (!strcmp(optarg, "spin")) {
+				spin = true;
+			}
+			else if (strcmp(optarg, "block")) {
+				fprintf(stderr, "ERROR: unknown wait strategy %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'z':
+			// static names, may be given more than once
+			zone_paths[nzones++] = optarg;
+			break;
+		default:
+			fprintf(stderr, "Usage:\n %s " USAGE "\n", argv[0], argv[0], argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	char** files = argv + optind;
+	int nfiles = argc - optind;
+	// with -Q every positional argument is an input file,
+	// with -d names come from clients instead
+	int ninputs = queue_name ? nfiles : socket_path ? 0 : nfiles - 1;
+	char** inputs = files;
+
+	if (use_uring && (stream || socket_path || queue_name || use_bin
+			  || (nfiles > 0 && !strcmp(files[nfiles-1], "-")))) {
+		fprintf(stderr, "ERROR: -i uring reads input files and writes a text output file\n");
+		return EXIT_FAILURE;
+	}
+	if (journal_path && (use_uring || stream || socket_path || queue_name || use_bin
+			     || (nfiles > 0 && !strcmp(files[nfiles-1], "-")))) {
+		fprintf(stderr, "ERROR: -j needs input files and a text output file, with -i stdio\n");
+		return EXIT_FAILURE;
+	}
+	if (reverse && (use_dedup || nzones > 0 || use_bin)) {
+		fprintf(stderr, "ERROR: -r cannot be used with -D, -z or -f bin\n");
+		return EXIT_FAILURE;
+	}
+	if (sort_mb && (use_uring || journal_path || stream || socket_path || queue_name || use_bin)) {
+		fprintf(stderr, "ERROR: -S sorts a text output file, it cannot be used with -i uring, -j, -s, -d, -Q or -f bin\n");
+		return EXIT_FAILURE;
+	}
+	if (stream && (socket_path || use_bin)) {
+		fprintf(stderr, "ERROR: -s cannot be used with -d or -f bin\n");
+		return EXIT_FAILURE;
+	}
+	// -s with no input paths reads stdin
+	if (stream && ninputs == 0 && (queue_name || nfiles == 1)) {
+		inputs = stdin_input;
+		ninputs = 1;
+	}
+
+	if (socket_path && (nfiles > 0 || queue_name || use_bin)) {
+		fprintf(stderr, "ERROR: -d takes no files and answers on the socket\n");
+		return EXIT_FAILURE;
+	}
 
 	// Checking for minimum args
-	if(argc < MINIMUM_ARGS) {
-		fprintf(stderr, "ERROR: Need at least 2 arguments. %d provided. \n", (argc - 1));
+	if(nfiles < MINIMUM_ARGS && !(queue_name && nfiles > 0) && !socket_path
+	   && !(stream && ninputs > 0)) {
+		fprintf(stderr, "ERROR: Need at least 2 arguments. %d provided. \n", nfiles);
+		fprintf(stderr, "Usage:\n %s " USAGE "\n", argv[0], argv[0], argv[0]);
 		return EXIT_FAILURE;
 	}
 
-    // OPEN SHARED OUTPUT FILE:
-    outputfp = fopen(argv[(argc-1)], "w"); // create open file pointer with write permissions
-    if(!outputfp)
-    {
-    	perror("ERROR: opening shared output file");
-    	return EXIT_FAILURE;
-    }
+	if (use_bin && queue_name) {
+		fprintf(stderr, "ERROR: -f bin writes a file, it cannot be used with -Q\n");
+		return EXIT_FAILURE;
+	}
 
-	// checking for max input files
-	if(argc > MAX_INPUT_FILES + 1) {
-		fprintf(stderr, "ERROR: More than 10 input files provided.");
+	if (stream) {
+		// a stream can stay open forever, so each gets its own producer
+		nproducers = ninputs;
+	}
+	else if (ninputs > 0) {
+		// EXPAND INPUTS into the work list the producer pool shares
+		if (worklist_init(&work) == WORKLIST_FAILURE) {
+			return EXIT_FAILURE;
+		}
+		for (i = 0; i < ninputs; i++) {
+			if (worklist_add(&work, inputs[i]) == WORKLIST_FAILURE) {
+				return EXIT_FAILURE;
+			}
+		}
+		// no point in more producers than files
+		nproducers = (size_t) pool_size < work.count ? pool_size : (int) work.count;
+	}
+
+	if (journal_path) {
+		// READ BACK PROGRESS from an interrupted run, if any
+		if (journal_open(&jrn, journal_path, work.paths, work.count,
+				 &resumed, &resume_size) == JOURNAL_FAILURE) {
+			return EXIT_FAILURE;
+		}
+		if (DEBUG && resumed) { fprintf(stderr, "resuming at output size %llu\n", (unsigned long long) resume_size); }
+	}
+
+	// READ CPU TOPOLOGY for -a, threads are placed as they are created
+	if (topology_init(&topo, placement) == TOPOLOGY_FAILURE) {
 		return EXIT_FAILURE;
 	}
+	if (DEBUG && placement != TOPOLOGY_NONE) { topology_print(&topo, stderr); }
+
+	// initialize shared buffer
+	queue_init(&buffer, buffer_size);
+
+	// spinning only helps when the thread we wait on can run meanwhile
+	if (spin && sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+		if (DEBUG) { fprintf(stderr, "single cpu, not spinning\n"); }
+		spin = false;
+	}
+	spinwait_init(&producer_spin, spin);
+	spinwait_init(&consumer_spin, spin);
+
+	if (rate_spec && ratelimit_init(&limit, rate_spec) == RATELIMIT_FAILURE) {
+		return EXIT_FAILURE;
+	}
+
+	// -s and -d run for as long as names keep coming, so the set has
+	// to forget old names and answers there
+	if (use_dedup && dedup_init(&dedup, (stream || socket_path) ? DEDUP_STREAM_CAPACITY : 0,
+				    (stream || socket_path) ? DEDUP_STREAM_TTL : 0) == DEDUP_FAILURE) {
+		return EXIT_FAILURE;
+	}
+
+	if (nzones > 0) {
+		// LOAD ZONE FILES into the lookup table, before any name is read
+		if (zone_load(&zones, zone_paths, nzones) == ZONE_FAILURE) {
+			return EXIT_FAILURE;
+		}
+		if (DEBUG) { fprintf(stderr, "zone: %zu names, %zu addresses, %zu bytes, parse %.3fs build %.3fs\n", zones.nnames, zones.naddrs, zone_memory(&zones), zones.parseSeconds, zones.buildSeconds); }
+	}
+
+	if (stream) {
+		// Block SIGINT/SIGTERM before any thread starts, so they all
+		// inherit it and the signal stays pending for stopfd to report
+		sigset_t mask;
+		sigemptyset(&mask);
+		sigaddset(&mask, SIGINT);
+		sigaddset(&mask, SIGTERM);
+		pthread_sigmask(SIG_BLOCK, &mask, NULL);
+		stopfd = signalfd(-1, &mask, SFD_CLOEXEC);
+		if (stopfd < 0) {
+			perror("ERROR: creating signalfd");
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (socket_path) {
+		// LISTEN FOR CLIENTS, before the resolvers start so they
+		// inherit the blocked SIGINT/SIGTERM mask
+		if (server_init(&srv, socket_path, daemon_submit, NULL) == SERVER_FAILURE) {
+			return EXIT_FAILURE;
+		}
+	}
+	else if (queue_name) {
+		// ATTACH TO THE AGGREGATOR'S QUEUE:
+		if (shmqueue_attach(&outputq, queue_name) == QUEUE_FAILURE) {
+			return EXIT_FAILURE;
+		}
+		shmqueue_add_producer(&outputq);
+	}
+	else if (use_bin) {
+		// OPEN BINARY OUTPUT FILE:
+		if (resfile_create(&bin, files[nfiles-1]) == RESFILE_FAILURE) {
+			return EXIT_FAILURE;
+		}
+	}
+	else if (use_uring) {
+		// START THE I/O THREAD, it creates the output file
+		if (fileio_init(&io, nproducers, files[nfiles-1]) == FILEIO_FAILURE) {
+			return EXIT_FAILURE;
+		}
+		if (DEBUG) { fprintf(stderr, "file I/O through %s\n", io.useRing ? "io_uring" : "pread/pwrite"); }
+		// the I/O thread writes every result
+		topology_pin(&topo, TOPOLOGY_WRITER, 0, io.thread);
+	}
+	else {
+		// OPEN SHARED OUTPUT FILE:
+		if (!strcmp(files[nfiles-1], "-")) {
+			outputfp = stdout;
+		}
+		else if (resumed) {
+			// keep what the journal accounts for, and drop anything
+			// written after its last checkpoint, it is redone
+			outputfp = fopen(files[nfiles-1], "a");
+			struct stat st;
+			if (outputfp && (fstat(fileno(outputfp), &st) || (uint64_t) st.st_size < resume_size)) {
+				fprintf(stderr, "ERROR: output file is shorter than the journal says, cannot resume\n");
+				return EXIT_FAILURE;
+			}
+			if (outputfp && ftruncate(fileno(outputfp), resume_size)) {
+				perror("ERROR: truncating output file");
+				return EXIT_FAILURE;
+			}
+		}
+		else {
+			outputfp = fopen(files[nfiles-1], "w"); // create open file pointer with write permissions
+		}
+		if(!outputfp)
+		{
+			perror("ERROR: opening shared output file");
+			return EXIT_FAILURE;
+		}
+		if (stream) {
+			// every result line reaches the reader as soon as it is written
+			setvbuf(outputfp, NULL, _IOLBF, 0);
+		}
+		if (sort_mb && extsort_init(&sorter, (size_t) sort_mb << 20) == EXTSORT_FAILURE) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	output.outputfp = outputfp;
+	output.outputq = queue_name ? &outputq : NULL;
+	output.bin = use_bin ? &bin : NULL;
+	output.io = use_uring ? &io : NULL;
+	output.journal = journal_path ? &jrn : NULL;
+	output.written = resume_size;
+	output.sorter = sort_mb ? &sorter : NULL;
 
 	// CREATE PRODUCER THREADS
-	thread_request_arg_t req_args[argc-1]; // length of # of input files
-    for(i=1; i<(argc-1); i++){ // until the last file
-        req_args[i-1].fname = argv[i]; // get the file name
-        req_args[i-1].buffer = &buffer; // add the shared buffer to each thread
-        // creating threads for each request 
-		int rc = pthread_create(&(producer_threads[i-1]), NULL, producer, &(req_args[i-1])); 
+	// daemon mode has no input files, keep the arrays non-empty
+	pthread_t producer_threads[nproducers ? nproducers : 1];
+	thread_request_arg_t req_args[nproducers ? nproducers : 1]; // one per producer
+    for(i=0; i<nproducers; i++){
+        req_args[i].fname = stream ? inputs[i] : NULL; // the stream to read
+        req_args[i].work = stream ? NULL : &work; // or the files to take from
+        req_args[i].buffer = &buffer; // add the shared buffer to each thread
+        req_args[i].output = &output; // repeats of resolved names are written directly
+        req_args[i].dedup = use_dedup ? &dedup : NULL;
+        req_args[i].zones = nzones > 0 ? &zones : NULL;
+        req_args[i].stopfd = stopfd;
+        // creating threads for each request, placed by -a
+		pthread_attr_t attr;
+		topology_attr(&topo, TOPOLOGY_PRODUCER, i, &attr);
+		int rc = pthread_create(&(producer_threads[i]), &attr,
+					stream ? stream_producer : producer, &(req_args[i])); 
+		pthread_attr_destroy(&attr);
 		if (rc){
 		    printf("Error making producer thread: %d\n", rc);
 		    exit(EXIT_FAILURE);
@@ -176,24 +1000,53 @@ int main(int argc, char* argv[]){
     // CREATE CONSUMER THREADS
     thread_resolve_arg_t res_args;
     res_args.rqueue = &buffer; // buffer for shared output
-    res_args.outputfp = outputfp; // make output file the same for all threads
+    res_args.output = &output; // make output file the same for all threads
+    res_args.dedup = use_dedup ? &dedup : NULL;
+    res_args.reverse = reverse;
+    res_args.limit = rate_spec ? &limit : NULL;
+    res_args.srv = socket_path ? &srv : NULL;
     for(i=0; i<MAX_RESOLVER_THREADS; i++){
-    	int rc = pthread_create(&(consumer_threads[i]), NULL, consumer, &res_args);
+    	pthread_attr_t attr;
+    	topology_attr(&topo, TOPOLOGY_RESOLVER, i, &attr);
+    	int rc = pthread_create(&(consumer_threads[i]), &attr, consumer, &res_args);
+    	pthread_attr_destroy(&attr);
     	if (rc){
     		printf("Error making consumer thread: %d\n", rc);
     		exit(EXIT_FAILURE);
     	}
     }
 
+    if (socket_path) {
+    	// SERVE CLIENTS UNTIL SIGINT/SIGTERM, resolvers and -D answers stay warm
+    	thread_request_arg_t daemon_args;
+    	daemon_args.fname = NULL;
+    	daemon_args.work = NULL;
+    	daemon_args.buffer = &buffer;
+    	daemon_args.output = &output;
+    	daemon_args.dedup = use_dedup ? &dedup : NULL;
+    	daemon_args.zones = nzones > 0 ? &zones : NULL;
+    	daemon_args.stopfd = -1;
+    	srv.submitArg = &daemon_args;
+    	// this thread runs the event loop, it writes every answer
+    	topology_pin(&topo, TOPOLOGY_WRITER, 0, pthread_self());
+    	server_run(&srv);
+    }
+
 	// WAIT FOR PRODUCER THREADS TO FINISH:
-    for(i=0; i<argc-2; i++){
+    for(i=0; i<nproducers; i++){
 		int rv = pthread_join(producer_threads[i],NULL);
 		if (rv) {
 			fprintf(stderr, "ERROR: on producer thread join");
 		}
     }
 
+    // tell consumers no more names are coming, waking any that are
+    // parked on an empty queue so they can exit. They drain whatever
+    // is still queued first, also after a SIGTERM in -s mode
+    pthread_mutex_lock(&buffer_mutex);
     buffer_finished = true;
+    pthread_cond_broadcast(&empty);
+    pthread_mutex_unlock(&buffer_mutex);
 
 
     // WAIT FOR CONSUMER THREADS TO FINISH:
@@ -211,8 +1064,65 @@ int main(int argc, char* argv[]){
 
     // Take care of mem leaks:
     queue_cleanup(&buffer);
-    // close shared output file:
-    fclose(outputfp);
+    if (use_dedup) {
+    	dedup_cleanup(&dedup);
+    }
+    if (nzones > 0) {
+    	zone_cleanup(&zones);
+    }
+    if (rate_spec) {
+    	if (DEBUG) { fprintf(stderr, "rate limit: %llu waits, %llu backoffs, ended at %.1f/s\n", (unsigned long long) limit.waits, (unsigned long long) limit.backoffs, limit.rate); }
+    	ratelimit_cleanup(&limit);
+    }
+    if (stopfd >= 0) {
+    	close(stopfd);
+    }
+    if (!stream && ninputs > 0) {
+    	worklist_cleanup(&work);
+    }
+    if (socket_path) {
+    	// names still queued were answered above, close the clients
+    	server_cleanup(&srv);
+    }
+    else if (queue_name) {
+    	// let the aggregator finish once every producer has left
+    	shmqueue_remove_producer(&outputq);
+    	shmqueue_detach(&outputq);
+    }
+    else if (use_bin) {
+    	// write the record table and index
+    	if (resfile_close(&bin) == RESFILE_FAILURE) {
+    		return EXIT_FAILURE;
+    	}
+    }
+    else if (use_uring) {
+    	// write out the last buffer and stop the I/O thread
+    	if (fileio_cleanup(&io) == FILEIO_FAILURE) {
+    		return EXIT_FAILURE;
+    	}
+    }
+    else {
+    	if (journal_path) {
+    		// last checkpoint, marks every finished file done
+    		pthread_mutex_lock(&output_mutex);
+    		if (fflush(outputfp) || fdatasync(fileno(outputfp))) {
+    			perror("ERROR: flushing output file");
+    		}
+    		pthread_mutex_unlock(&output_mutex);
+    		if (journal_close(&jrn, output.written) == JOURNAL_FAILURE) {
+    			return EXIT_FAILURE;
+    		}
+    	}
+    	if (sort_mb) {
+    		// merge the sorted runs into the output
+    		if (extsort_finish(&sorter, outputfp) == EXTSORT_FAILURE) {
+    			return EXIT_FAILURE;
+    		}
+    		if (DEBUG) { fprintf(stderr, "sorted %llu lines into %llu, %zu runs, %d merge threads\n", (unsigned long long) sorter.linesIn, (unsigned long long) sorter.linesOut, sorter.nruns, sorter.mergeThreads); }
+    	}
+    	// close shared output file:
+    	fclose(outputfp);
+    }
 
 
     // // destroy condition variables
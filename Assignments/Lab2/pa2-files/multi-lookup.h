@@ -1,17 +1,46 @@
 #ifndef MULT_LOOKUP_H
 #define MULT_LOOKUP_H
 
+// where results end up: the output file, or an aggregator's queue
 typedef struct {
-    char* fname;
+    FILE* outputfp;
+    shmqueue* outputq;
+    resfile_writer* bin; // -f bin
+    fileio* io; // -i uring, also reads the input files
+    journal* journal; // -j, progress of the output file
+    uint64_t written; // output bytes so far, with -j
+    extsort* sorter; // -S, lines go here until the run ends
+} output_t;
+
+// one name on the shared buffer
+typedef struct {
+    dedup_entry* entry; // set with -D, repeats wait on it
+    server_conn* conn; // daemon client that asked, NULL for input files
+    journal_ticket ticket; // -j: input file and name number, jf NULL otherwise
+    char hostname[];
+} lookup_request_t;
+
+typedef struct {
+    char* fname; // -s: the stream this producer reads
+    worklist* work; // otherwise: input files shared by the pool
     queue* buffer;
+    output_t* output;
+    dedup_set* dedup; // NULL unless -D
+    const zone* zones; // -z: names answered without a lookup, or NULL
+    int stopfd; // -s: readable once SIGINT/SIGTERM is pending
 } thread_request_arg_t;
 
 typedef struct {
     queue* rqueue;
-    FILE* outputfp;
+    output_t* output;
+    dedup_set* dedup;
+    bool reverse; // -r: requests hold addresses, answers are names
+    ratelimit* limit; // -q: paces lookups sent upstream, or NULL
+    server* srv; // -d: told when the buffer has room again, or NULL
 } thread_resolve_arg_t;
 
 void* producer(void*);
+void* stream_producer(void*);
 void* consumer(void*);
 
-#endif
\ No newline at end of file
+#endif
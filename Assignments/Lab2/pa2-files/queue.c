@@ -65,6 +65,13 @@ int queue_is_full(queue* q){
     }
 }
 
+int queue_count(queue* q){
+    if(queue_is_full(q)){
+	return q->maxSize;
+    }
+    return (q->rear - q->front + q->maxSize) % q->maxSize;
+}
+
 void* queue_pop(queue* q){
     void* ret_payload;
 	
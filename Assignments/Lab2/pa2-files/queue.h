@@ -50,6 +50,11 @@ int queue_is_empty(queue* q);
  */
 int queue_is_full(queue* q);
 
+/* Function to count the elements in the queue
+ * Returns a number between 0 and the queue size
+ */
+int queue_count(queue* q);
+
 /* Function add payload to end of FIFO queue
  * Returns QUEUE_SUCCESS if the push successeds.
  * Returns QUEUE_FAILURE if the push fails
@@ -0,0 +1,127 @@
+/*
+ * File: ratelimit.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the token bucket and backoff that limit
+ *      the lookups multi-lookup -q sends upstream.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "ratelimit.h"
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int ratelimit_init(ratelimit* rl, const char* spec){
+    char* end;
+
+    rl->maxRate = strtod(spec, &end);
+    rl->burst = rl->maxRate / 10;
+    if(*end == ':'){
+	rl->burst = strtod(end + 1, &end);
+    }
+    /* strtod takes "nan" and "inf", neither is a rate */
+    if(*end != '\0' || !isfinite(rl->maxRate) || !isfinite(rl->burst) ||
+       rl->maxRate < RATELIMIT_MIN_RATE || rl->burst < 0){
+	fprintf(stderr, "Bad rate limit %s, want queries per second[:burst]\n",
+		spec);
+	return RATELIMIT_FAILURE;
+    }
+    if(rl->burst < 1){
+	rl->burst = 1;
+    }
+    rl->rate = rl->maxRate;
+    rl->minRate = rl->maxRate * RATELIMIT_FLOOR;
+    if(rl->minRate < RATELIMIT_MIN_RATE){
+	rl->minRate = RATELIMIT_MIN_RATE;
+    }
+    rl->tokens = rl->burst;
+    rl->last = now();
+    rl->holdUntil = 0;
+    rl->waits = 0;
+    rl->backoffs = 0;
+    if(pthread_mutex_init(&rl->lock, NULL)){
+	perror("Error on ratelimit Mutex");
+	return RATELIMIT_FAILURE;
+    }
+    return RATELIMIT_SUCCESS;
+}
+
+/* Add the tokens earned since the last refill, with the lock held */
+static void refill(ratelimit* rl, double t){
+    rl->tokens += (t - rl->last) * rl->rate;
+    if(rl->tokens > rl->burst){
+	rl->tokens = rl->burst;
+    }
+    rl->last = t;
+}
+
+void ratelimit_acquire(ratelimit* rl){
+    double wait = 0;
+    struct timespec ts;
+
+    pthread_mutex_lock(&rl->lock);
+    refill(rl, now());
+    /* take the token now even if it is not there yet, the debt is
+     * paid off by sleeping until it would have been */
+    rl->tokens -= 1;
+    if(rl->tokens < 0){
+	wait = -rl->tokens / rl->rate;
+	rl->waits++;
+    }
+    pthread_mutex_unlock(&rl->lock);
+
+    if(wait > 0){
+	ts.tv_sec = (time_t)wait;
+	ts.tv_nsec = (long)((wait - ts.tv_sec) * 1e9);
+	while(nanosleep(&ts, &ts)){
+	    /* interrupted, sleep the rest */
+	}
+    }
+}
+
+void ratelimit_result(ratelimit* rl, bool overloaded){
+    double t;
+
+    pthread_mutex_lock(&rl->lock);
+    t = now();
+    refill(rl, t);
+    if(overloaded){
+	if(t >= rl->holdUntil){
+	    rl->rate *= RATELIMIT_DECREASE;
+	    if(rl->rate < rl->minRate){
+		rl->rate = rl->minRate;
+	    }
+	    /* a saved up burst would go out at the old rate */
+	    if(rl->tokens > 0){
+		rl->tokens = 0;
+	    }
+	    rl->holdUntil = t + RATELIMIT_HOLD;
+	    rl->backoffs++;
+	}
+    }
+    else if(rl->rate < rl->maxRate){
+	/* rate answers a second, so this adds INCREASE of the full
+	 * rate per second whatever the rate is now */
+	rl->rate += rl->maxRate * RATELIMIT_INCREASE / rl->rate;
+	if(rl->rate > rl->maxRate){
+	    rl->rate = rl->maxRate;
+	}
+    }
+    pthread_mutex_unlock(&rl->lock);
+}
+
+void ratelimit_cleanup(ratelimit* rl){
+    pthread_mutex_destroy(&rl->lock);
+}
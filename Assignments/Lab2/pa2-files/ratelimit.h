@@ -0,0 +1,77 @@
+/*
+ * File: ratelimit.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the upstream rate limit of
+ *      multi-lookup -q. Resolvers take a token from a token bucket
+ *      before each lookup: tokens come back at the current rate and
+ *      at most burst of them are saved up while the resolvers are
+ *      idle. When the upstream answers SERVFAIL or REFUSED, or does
+ *      not answer at all, the rate is halved (at most once per hold
+ *      time, the failures of queries already in flight do not count
+ *      again), down to an eighth of the configured rate. Every
+ *      successful lookup then adds a little back, so the full
+ *      configured rate is reached again after about
+ *      1 / RATELIMIT_INCREASE seconds of clean answers.
+ *
+ *      getaddrinfo does not say which nameserver a query went to,
+ *      and without "options rotate" the stub resolver sends every
+ *      query to the first one in resolv.conf, so the system resolver
+ *      is one upstream and gets one bucket.
+ *
+ */
+
+#ifndef RATELIMIT_H
+#define RATELIMIT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RATELIMIT_FAILURE -1
+#define RATELIMIT_SUCCESS 0
+
+#define RATELIMIT_MIN_RATE 1.0      /* lowest rate that can be asked for */
+#define RATELIMIT_FLOOR 0.125       /* share of the full rate backoff keeps,
+				     * so a dead upstream does not stall
+				     * the run at one query a second */
+#define RATELIMIT_DECREASE 0.5      /* rate kept on an upstream failure */
+#define RATELIMIT_INCREASE 0.05     /* share of the full rate regained per
+				     * second of successful lookups */
+#define RATELIMIT_HOLD 1.0          /* seconds between two decreases */
+#define RATELIMIT_RETRIES 1         /* extra tries for a temporary failure */
+
+typedef struct ratelimit_s{
+    pthread_mutex_t lock;
+    double maxRate;             /* configured queries per second */
+    double rate;                /* current, after backoff */
+    double minRate;             /* backoff stops here */
+    double burst;               /* most tokens saved up */
+    double tokens;              /* below zero when lookups are waiting */
+    double last;                /* when tokens were last added */
+    double holdUntil;           /* no decrease before this */
+    uint64_t waits;             /* lookups that had to wait for a token */
+    uint64_t backoffs;          /* times the rate was cut */
+} ratelimit;
+
+/* Function to set up a limit from "rate[:burst]", queries per second
+ * and the burst size. Without a burst a tenth of a second of queries
+ * may go at once. Both must be finite numbers.
+ * Returns RATELIMIT_SUCCESS or RATELIMIT_FAILURE for a bad spec
+ */
+int ratelimit_init(ratelimit* rl, const char* spec);
+
+/* Function to wait until a lookup may be sent. Thread safe, waiters
+ * each reserve a token so they are let through in arrival order. */
+void ratelimit_acquire(ratelimit* rl);
+
+/* Function to report how a lookup went. overloaded is true for a
+ * temporary failure upstream, false for any answer, even NXDOMAIN. */
+void ratelimit_result(ratelimit* rl, bool overloaded);
+
+/* Function to free a limit */
+void ratelimit_cleanup(ratelimit* rl);
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * File: resfile-query.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Reads a binary results file written by multi-lookup -f bin.
+ *      With only a file it prints every record in the text format,
+ *      with hostnames it looks each one up through the index.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "resfile.h"
+
+#define MINARGS 2
+#define USAGE "<resultsFilePath> [hostname ...]"
+
+static void print_record(const char* name, size_t nameLen, const ip_list_t* ips){
+    char ipstr[UTIL_ADDRSTRLEN];
+    int i;
+
+    fwrite(name, 1, nameLen, stdout);
+    putchar(',');
+    for(i=0; i<ips->naddrs; i++){
+	ip_format(&ips->addrs[i], ipstr);
+	fputs(ipstr, stdout);
+	if(i < ips->naddrs - 1){
+	    putchar(',');
+	}
+    }
+    putchar('\n');
+}
+
+int main(int argc, char* argv[]){
+
+    /* Local Vars */
+    resfile f;
+    ip_list_t ips;
+    const char* name;
+    size_t nameLen;
+    uint64_t n;
+    int i;
+    int missing = 0;
+
+    /* Check Arguments */
+    if(argc < MINARGS){
+	fprintf(stderr, "Not enough arguments: %d\n", (argc - 1));
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	return EXIT_FAILURE;
+    }
+
+    if(resfile_open(&f, argv[1]) == RESFILE_FAILURE){
+	return EXIT_FAILURE;
+    }
+
+    if(argc == MINARGS){
+	/* Dump everything */
+	for(n=0; n<resfile_count(&f); n++){
+	    resfile_get(&f, n, &name, &nameLen, &ips);
+	    print_record(name, nameLen, &ips);
+	}
+    }
+    else{
+	/* Indexed lookups */
+	for(i=2; i<argc; i++){
+	    if(resfile_lookup(&f, argv[i], &ips) == RESFILE_FAILURE){
+		fprintf(stderr, "not found: %s\n", argv[i]);
+		missing++;
+		continue;
+	    }
+	    print_record(argv[i], strlen(argv[i]), &ips);
+	}
+    }
+
+    resfile_unmap(&f);
+
+    return missing ? EXIT_FAILURE : EXIT_SUCCESS;
+}
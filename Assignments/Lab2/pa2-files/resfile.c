@@ -0,0 +1,328 @@
+/*
+ * File: resfile.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the writer and the mmap reader for the
+ *      binary results format described in resfile.h.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "resfile.h"
+
+/* FNV-1a, shared by the index builder and lookups */
+static uint64_t resfile_hash(const char* name, size_t len){
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i;
+
+    for(i=0; i<len; i++){
+	h ^= (unsigned char)name[i];
+	h *= 0x100000001b3ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+/* Grow *array to hold at least need elements */
+static int reserve(void** array, uint64_t* cap, uint64_t need, size_t elem){
+    uint64_t newCap;
+    void* p;
+
+    if(need <= *cap){
+	return RESFILE_SUCCESS;
+    }
+    newCap = *cap ? *cap * 2 : 1024;
+    while(newCap < need){
+	newCap *= 2;
+    }
+    p = realloc(*array, newCap * elem);
+    if(!p){
+	perror("Error on resfile Malloc");
+	return RESFILE_FAILURE;
+    }
+    *array = p;
+    *cap = newCap;
+    return RESFILE_SUCCESS;
+}
+
+int resfile_create(resfile_writer* w, const char* path){
+    resfile_header hdr;
+
+    memset(w, 0, sizeof(*w));
+    w->fp = fopen(path, "w");
+    if(!w->fp){
+	perror("Error opening results file");
+	return RESFILE_FAILURE;
+    }
+
+    /* Placeholder header, rewritten by resfile_close */
+    memset(&hdr, 0, sizeof(hdr));
+    if(fwrite(&hdr, sizeof(hdr), 1, w->fp) != 1){
+	perror("Error writing results file");
+	fclose(w->fp);
+	return RESFILE_FAILURE;
+    }
+    return RESFILE_SUCCESS;
+}
+
+int resfile_append(resfile_writer* w, const char* hostname,
+		   const ip_list_t* ips){
+    size_t len = strlen(hostname);
+    resfile_record* r;
+    int i;
+
+    if(reserve((void**)&w->records, &w->recordsCap, w->nrecords + 1,
+	       sizeof(*w->records)) ||
+       reserve((void**)&w->hashes, &w->hashesCap, w->nrecords + 1,
+	       sizeof(*w->hashes))){
+	return RESFILE_FAILURE;
+    }
+    if(reserve((void**)&w->addrs, &w->addrsCap, w->naddrs + ips->naddrs,
+	       sizeof(*w->addrs))){
+	return RESFILE_FAILURE;
+    }
+
+    if(fwrite(hostname, 1, len, w->fp) != len){
+	perror("Error writing results file");
+	return RESFILE_FAILURE;
+    }
+
+    r = &w->records[w->nrecords];
+    r->nameOffset = w->heapSize;
+    r->nameLen = len;
+    r->firstAddr = w->naddrs;
+    r->naddrs = ips->naddrs;
+    r->reserved = 0;
+    w->hashes[w->nrecords] = resfile_hash(hostname, len);
+    w->nrecords++;
+    w->heapSize += len;
+
+    for(i=0; i<ips->naddrs; i++){
+	resfile_addr* a = &w->addrs[w->naddrs++];
+	memset(a, 0, sizeof(*a));
+	a->family = ips->addrs[i].family;
+	memcpy(a->addr, ips->addrs[i].addr, sizeof(a->addr));
+    }
+    return RESFILE_SUCCESS;
+}
+
+/* Pad the file to an 8 byte boundary so sections are aligned */
+static uint64_t align_file(FILE* fp, uint64_t offset){
+    static const char zeros[8];
+    uint64_t pad = (8 - (offset & 7)) & 7;
+
+    fwrite(zeros, 1, pad, fp);
+    return offset + pad;
+}
+
+int resfile_close(resfile_writer* w){
+    resfile_header hdr;
+    uint32_t* index = NULL;
+    uint64_t offset;
+    uint64_t i;
+    int rv = RESFILE_SUCCESS;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, RESFILE_MAGIC, sizeof(RESFILE_MAGIC));
+    hdr.nrecords = w->nrecords;
+    hdr.heapOffset = sizeof(hdr);
+    hdr.heapSize = w->heapSize;
+    hdr.naddrs = w->naddrs;
+
+    /* Index at load factor <= 1/2 */
+    hdr.indexSlots = 16;
+    while(hdr.indexSlots < 2 * w->nrecords){
+	hdr.indexSlots *= 2;
+    }
+    index = calloc(hdr.indexSlots, sizeof(*index));
+    if(!index){
+	perror("Error on resfile Malloc");
+	rv = RESFILE_FAILURE;
+	goto out;
+    }
+    for(i=0; i<w->nrecords; i++){
+	uint64_t slot = w->hashes[i] & (hdr.indexSlots - 1);
+	while(index[slot]){
+	    /* Index only the first copy of a repeated hostname, so
+	     * repeats do not build long probe runs. Names are not in
+	     * memory here; equal 64 bit hash and length stand in. */
+	    uint32_t other = index[slot] - 1;
+	    if(w->hashes[other] == w->hashes[i] &&
+	       w->records[other].nameLen == w->records[i].nameLen){
+		break;
+	    }
+	    slot = (slot + 1) & (hdr.indexSlots - 1);
+	}
+	if(!index[slot]){
+	    index[slot] = i + 1;
+	}
+    }
+
+    offset = align_file(w->fp, hdr.heapOffset + hdr.heapSize);
+    hdr.recordsOffset = offset;
+    fwrite(w->records, sizeof(*w->records), w->nrecords, w->fp);
+    offset += w->nrecords * sizeof(*w->records);
+    hdr.addrsOffset = offset;
+    fwrite(w->addrs, sizeof(*w->addrs), w->naddrs, w->fp);
+    offset = align_file(w->fp, offset + w->naddrs * sizeof(*w->addrs));
+    hdr.indexOffset = offset;
+    fwrite(index, sizeof(*index), hdr.indexSlots, w->fp);
+
+    /* Header last, a crashed run leaves no valid magic */
+    if(fseek(w->fp, 0, SEEK_SET) ||
+       fwrite(&hdr, sizeof(hdr), 1, w->fp) != 1 ||
+       ferror(w->fp)){
+	perror("Error writing results file");
+	rv = RESFILE_FAILURE;
+    }
+
+ out:
+    if(fclose(w->fp)){
+	perror("Error closing results file");
+	rv = RESFILE_FAILURE;
+    }
+    free(index);
+    free(w->records);
+    free(w->hashes);
+    free(w->addrs);
+    return rv;
+}
+
+/* Does a section of count elem sized entries at offset fit in size
+ * bytes, without overflowing on garbage */
+static int section_fits(uint64_t offset, uint64_t count, size_t elem, uint64_t size){
+    return offset <= size && count <= (size - offset) / elem;
+}
+
+/* Every record must name bytes inside the heap and addresses inside
+ * the address table, and every index entry a record, so lookups can
+ * follow them without further checks */
+static int check_entries(const resfile* f){
+    const resfile_header* h = f->hdr;
+    uint64_t i;
+
+    for(i=0; i<h->nrecords; i++){
+	const resfile_record* r = &f->records[i];
+	if(r->nameOffset > h->heapSize ||
+	   r->nameLen > h->heapSize - r->nameOffset ||
+	   r->firstAddr > h->naddrs ||
+	   r->naddrs > h->naddrs - r->firstAddr){
+	    return RESFILE_FAILURE;
+	}
+    }
+    for(i=0; i<h->indexSlots; i++){
+	if(f->index[i] > h->nrecords){
+	    return RESFILE_FAILURE;
+	}
+    }
+    return RESFILE_SUCCESS;
+}
+
+int resfile_open(resfile* f, const char* path){
+    struct stat st;
+    const resfile_header* h;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if(fd < 0){
+	perror("Error opening results file");
+	return RESFILE_FAILURE;
+    }
+    if(fstat(fd, &st) || (size_t)st.st_size < sizeof(resfile_header)){
+	fprintf(stderr, "Error opening results file: too short\n");
+	close(fd);
+	return RESFILE_FAILURE;
+    }
+    f->map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(f->map == MAP_FAILED){
+	perror("Error mapping results file");
+	return RESFILE_FAILURE;
+    }
+    f->mapSize = st.st_size;
+
+    /* Check every section lies inside the file before trusting it */
+    h = (const resfile_header*)f->map;
+    if(memcmp(h->magic, RESFILE_MAGIC, sizeof(RESFILE_MAGIC)) ||
+       !section_fits(h->heapOffset, h->heapSize, 1, f->mapSize) ||
+       !section_fits(h->recordsOffset, h->nrecords, sizeof(resfile_record), f->mapSize) ||
+       !section_fits(h->addrsOffset, h->naddrs, sizeof(resfile_addr), f->mapSize) ||
+       !section_fits(h->indexOffset, h->indexSlots, sizeof(uint32_t), f->mapSize) ||
+       (h->recordsOffset | h->addrsOffset | h->indexOffset) & 7 ||
+       h->indexSlots == 0 || (h->indexSlots & (h->indexSlots - 1))){
+	fprintf(stderr, "Error opening results file: bad header\n");
+	munmap((void*)f->map, f->mapSize);
+	return RESFILE_FAILURE;
+    }
+    f->hdr = h;
+    f->heap = (const char*)f->map + h->heapOffset;
+    f->records = (const resfile_record*)(f->map + h->recordsOffset);
+    f->addrs = (const resfile_addr*)(f->map + h->addrsOffset);
+    f->index = (const uint32_t*)(f->map + h->indexOffset);
+    if(check_entries(f) == RESFILE_FAILURE){
+	fprintf(stderr, "Error opening results file: bad record or index entry\n");
+	munmap((void*)f->map, f->mapSize);
+	return RESFILE_FAILURE;
+    }
+
+    return RESFILE_SUCCESS;
+}
+
+uint64_t resfile_count(const resfile* f){
+    return f->hdr->nrecords;
+}
+
+void resfile_get(const resfile* f, uint64_t i,
+		 const char** name, size_t* nameLen, ip_list_t* ips){
+    const resfile_record* r = &f->records[i];
+    uint32_t j;
+
+    *name = f->heap + r->nameOffset;
+    *nameLen = r->nameLen;
+    if(!ips){
+	return;
+    }
+    ips->naddrs = 0;
+    for(j=0; j<r->naddrs && j<UTIL_MAX_ADDRS; j++){
+	const resfile_addr* a = &f->addrs[r->firstAddr + j];
+	ips->addrs[j].family = a->family;
+	memcpy(ips->addrs[j].addr, a->addr, sizeof(a->addr));
+	ips->naddrs++;
+    }
+}
+
+int64_t resfile_lookup(const resfile* f, const char* hostname,
+		       ip_list_t* ips){
+    size_t len = strlen(hostname);
+    uint64_t mask = f->hdr->indexSlots - 1;
+    uint64_t slot = resfile_hash(hostname, len) & mask;
+    uint64_t probes;
+    uint32_t rec;
+
+    /* the writer always leaves empty slots, a damaged index may not */
+    for(probes=0; probes<=mask && (rec = f->index[slot]) != 0; probes++){
+	const resfile_record* r = &f->records[rec - 1];
+	if(r->nameLen == len &&
+	   !memcmp(f->heap + r->nameOffset, hostname, len)){
+	    const char* name;
+	    size_t nameLen;
+	    resfile_get(f, rec - 1, &name, &nameLen, ips);
+	    return rec - 1;
+	}
+	slot = (slot + 1) & mask;
+    }
+    return RESFILE_FAILURE;
+}
+
+void resfile_unmap(resfile* f){
+    munmap((void*)f->map, f->mapSize);
+}
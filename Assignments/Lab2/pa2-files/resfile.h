@@ -0,0 +1,130 @@
+/*
+ * File: resfile.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the binary results format written
+ *      by multi-lookup -f bin, and for the mmap based reader library
+ *      used to query it without parsing text.
+ *
+ *      File layout, all integers in host byte order:
+ *        header        resfile_header, 72 bytes
+ *        string heap   hostnames, back to back, no terminators
+ *        records       resfile_record[nrecords], fixed width
+ *        addresses     resfile_addr[naddrs], records point into it
+ *        index         uint32_t[indexSlots], open addressing hash of
+ *                      hostname to record number + 1 (0 is empty)
+ *
+ */
+
+#ifndef RESFILE_H
+#define RESFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "util.h"
+
+#define RESFILE_FAILURE -1
+#define RESFILE_SUCCESS 0
+
+#define RESFILE_MAGIC "MLRES01"
+
+typedef struct resfile_header_s{
+    char magic[8];
+    uint64_t nrecords;
+    uint64_t heapOffset;
+    uint64_t heapSize;
+    uint64_t recordsOffset;
+    uint64_t addrsOffset;
+    uint64_t naddrs;
+    uint64_t indexOffset;
+    uint64_t indexSlots;    /* power of two */
+} resfile_header;
+
+typedef struct resfile_record_s{
+    uint64_t nameOffset;    /* into the string heap */
+    uint32_t nameLen;
+    uint32_t firstAddr;     /* into the address table */
+    uint32_t naddrs;
+    uint32_t reserved;
+} resfile_record;
+
+typedef struct resfile_addr_s{
+    uint8_t family;         /* AF_INET or AF_INET6 */
+    uint8_t reserved[3];
+    uint8_t addr[16];
+} resfile_addr;
+
+/* Writer: hostnames stream straight to the heap section, records
+ * and addresses are kept in memory until resfile_close */
+typedef struct resfile_writer_s{
+    FILE* fp;
+    uint64_t heapSize;
+    resfile_record* records;
+    uint64_t* hashes;       /* per record, to build the index */
+    uint64_t hashesCap;
+    uint64_t nrecords;
+    uint64_t recordsCap;
+    resfile_addr* addrs;
+    uint64_t naddrs;
+    uint64_t addrsCap;
+} resfile_writer;
+
+/* Reader: the whole file mapped read only */
+typedef struct resfile_s{
+    const unsigned char* map;
+    size_t mapSize;
+    const resfile_header* hdr;
+    const char* heap;
+    const resfile_record* records;
+    const resfile_addr* addrs;
+    const uint32_t* index;
+} resfile;
+
+/* Function to start a new results file
+ * Returns RESFILE_SUCCESS or RESFILE_FAILURE
+ */
+int resfile_create(resfile_writer* w, const char* path);
+
+/* Function to append one hostname and its addresses
+ * Not thread safe, callers serialize as for the text output
+ * Returns RESFILE_SUCCESS or RESFILE_FAILURE
+ */
+int resfile_append(resfile_writer* w, const char* hostname,
+		   const ip_list_t* ips);
+
+/* Function to write the record table, addresses and index, then
+ * close the file
+ * Returns RESFILE_SUCCESS or RESFILE_FAILURE
+ */
+int resfile_close(resfile_writer* w);
+
+/* Function to map a results file for reading
+ * Every section, record and index entry is checked against the file
+ * first, so a truncated or damaged file is refused, never read past
+ * Returns RESFILE_SUCCESS or RESFILE_FAILURE
+ */
+int resfile_open(resfile* f, const char* path);
+
+/* Function to return the number of records */
+uint64_t resfile_count(const resfile* f);
+
+/* Function to read record i
+ * name points into the mapping and is not NUL terminated
+ */
+void resfile_get(const resfile* f, uint64_t i,
+		 const char** name, size_t* nameLen, ip_list_t* ips);
+
+/* Function to find hostname through the embedded index
+ * Returns the record number of the first match, or RESFILE_FAILURE
+ */
+int64_t resfile_lookup(const resfile* f, const char* hostname,
+		       ip_list_t* ips);
+
+/* Function to unmap a results file */
+void resfile_unmap(resfile* f);
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * File: resfileTest.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains test code for the binary results format.
+ *      Names are written, read back by record number and looked up
+ *      through the index. Then damaged copies of the file (cut
+ *      short, bad offsets, an index with no empty slot) must be
+ *      refused by resfile_open or fail lookups cleanly.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "resfile.h"
+
+#define TEST_SIZE 1000
+#define TEST_FILE "resfileTest.bin"
+#define DAMAGED_FILE "resfileTest-damaged.bin"
+
+/* The addresses written for name i, i % 4 of them, v4 and v6 */
+static void test_ips(int i, ip_list_t* ips){
+    int j;
+
+    memset(ips, 0, sizeof(*ips));
+    for(j=0; j<i%4; j++){
+	ip_addr_t* a = &ips->addrs[ips->naddrs++];
+	a->family = j % 2 ? AF_INET6 : AF_INET;
+	a->addr[0] = i & 0xff;
+	a->addr[1] = i >> 8;
+	a->addr[15] = j;
+    }
+}
+
+static int same_ips(const ip_list_t* a, const ip_list_t* b){
+    int i;
+
+    if(a->naddrs != b->naddrs){
+	return 0;
+    }
+    for(i=0; i<a->naddrs; i++){
+	if(a->addrs[i].family != b->addrs[i].family ||
+	   memcmp(a->addrs[i].addr, b->addrs[i].addr, sizeof(a->addrs[i].addr))){
+	    return 0;
+	}
+    }
+    return 1;
+}
+
+/* Read the whole test file into memory */
+static unsigned char* load(size_t* size){
+    unsigned char* data;
+    FILE* fp = fopen(TEST_FILE, "r");
+
+    if(!fp){
+	return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    rewind(fp);
+    data = malloc(*size);
+    if(data && fread(data, 1, *size, fp) != *size){
+	free(data);
+	data = NULL;
+    }
+    fclose(fp);
+    return data;
+}
+
+/* Write a damaged copy and check resfile_open refuses it */
+static int expect_refused(const char* what, const unsigned char* data, size_t size){
+    FILE* fp = fopen(DAMAGED_FILE, "w");
+    resfile f;
+
+    if(!fp || fwrite(data, 1, size, fp) != size){
+	perror("fopen");
+	return 1;
+    }
+    fclose(fp);
+    if(resfile_open(&f, DAMAGED_FILE) != RESFILE_FAILURE){
+	fprintf(stderr,
+		"error: resfile_open accepted a file with %s\n", what);
+	resfile_unmap(&f);
+	return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    resfile_writer w;
+    resfile f;
+    resfile_header hdr;
+    resfile_record* rec;
+    uint32_t* index;
+    ip_list_t ips;
+    ip_list_t got;
+    char name[64];
+    const char* gotName;
+    size_t gotLen;
+    unsigned char* data;
+    unsigned char* copy;
+    size_t size;
+    uint64_t i;
+    int errors = 0;
+
+    /* Write TEST_SIZE names, and the first one again at the end */
+    if(resfile_create(&w, TEST_FILE) == RESFILE_FAILURE){
+	return EXIT_FAILURE;
+    }
+    for(i=0; i<=TEST_SIZE; i++){
+	snprintf(name, sizeof(name), "host%d.example.com", (int)(i % TEST_SIZE));
+	test_ips(i, &ips);
+	if(resfile_append(&w, name, &ips) == RESFILE_FAILURE){
+	    fprintf(stderr, "error: resfile_append failed!\n");
+	    return EXIT_FAILURE;
+	}
+    }
+    if(resfile_close(&w) == RESFILE_FAILURE){
+	fprintf(stderr, "error: resfile_close failed!\n");
+	return EXIT_FAILURE;
+    }
+
+    /* Read it back */
+    if(resfile_open(&f, TEST_FILE) == RESFILE_FAILURE){
+	fprintf(stderr, "error: resfile_open failed!\n");
+	return EXIT_FAILURE;
+    }
+    if(resfile_count(&f) != TEST_SIZE + 1){
+	fprintf(stderr, "error: %llu records, expected %d\n",
+		(unsigned long long)resfile_count(&f), TEST_SIZE + 1);
+	errors++;
+    }
+    for(i=0; i<resfile_count(&f); i++){
+	snprintf(name, sizeof(name), "host%d.example.com", (int)(i % TEST_SIZE));
+	test_ips(i, &ips);
+	resfile_get(&f, i, &gotName, &gotLen, &got);
+	if(gotLen != strlen(name) || memcmp(gotName, name, gotLen) ||
+	   !same_ips(&ips, &got)){
+	    fprintf(stderr,
+		    "error: record %llu does not match %s\n",
+		    (unsigned long long)i, name);
+	    errors++;
+	}
+    }
+    /* Lookups find the first copy of a name */
+    for(i=0; i<TEST_SIZE; i++){
+	snprintf(name, sizeof(name), "host%d.example.com", (int)i);
+	test_ips(i, &ips);
+	if(resfile_lookup(&f, name, &got) != (int64_t)i || !same_ips(&ips, &got)){
+	    fprintf(stderr,
+		    "error: lookup of %s failed\n", name);
+	    errors++;
+	}
+    }
+    if(resfile_lookup(&f, "missing.example.com", &got) != RESFILE_FAILURE){
+	fprintf(stderr, "error: lookup of a missing name succeeded\n");
+	errors++;
+    }
+    memcpy(&hdr, f.hdr, sizeof(hdr));
+    resfile_unmap(&f);
+
+    /* Damaged copies */
+    data = load(&size);
+    copy = malloc(size);
+    if(!data || !copy){
+	perror("load");
+	return EXIT_FAILURE;
+    }
+    errors += expect_refused("its end cut off", data, size / 2);
+
+    memcpy(copy, data, size);
+    rec = (resfile_record*)(copy + hdr.recordsOffset);
+    rec[TEST_SIZE / 2].nameOffset = hdr.heapSize;
+    rec[TEST_SIZE / 2].nameLen = 1;
+    errors += expect_refused("a name past the heap", copy, size);
+
+    memcpy(copy, data, size);
+    rec = (resfile_record*)(copy + hdr.recordsOffset);
+    rec[3].firstAddr = hdr.naddrs - 1;
+    errors += expect_refused("addresses past the table", copy, size);
+
+    memcpy(copy, data, size);
+    index = (uint32_t*)(copy + hdr.indexOffset);
+    index[hdr.indexSlots - 1] = hdr.nrecords + 1;
+    errors += expect_refused("an index entry past the records", copy, size);
+
+    memcpy(copy, data, size);
+    ((resfile_header*)copy)->heapSize = UINT64_MAX;
+    errors += expect_refused("a heap size that overflows", copy, size);
+
+    /* An index with no empty slot is valid entry by entry, lookups of
+     * a missing name must still end */
+    memcpy(copy, data, size);
+    index = (uint32_t*)(copy + hdr.indexOffset);
+    for(i=0; i<hdr.indexSlots; i++){
+	index[i] = 1;
+    }
+    {
+	FILE* fp = fopen(DAMAGED_FILE, "w");
+	if(!fp || fwrite(copy, 1, size, fp) != size){
+	    perror("fopen");
+	    return EXIT_FAILURE;
+	}
+	fclose(fp);
+    }
+    if(resfile_open(&f, DAMAGED_FILE) == RESFILE_FAILURE){
+	fprintf(stderr, "error: resfile_open refused a full index\n");
+	errors++;
+    }
+    else{
+	if(resfile_lookup(&f, "missing.example.com", &got) != RESFILE_FAILURE){
+	    fprintf(stderr, "error: lookup in a full index succeeded\n");
+	    errors++;
+	}
+	resfile_unmap(&f);
+    }
+
+    /* Cleanup */
+    free(data);
+    free(copy);
+    unlink(TEST_FILE);
+    unlink(DAMAGED_FILE);
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,488 @@
+/*
+ * File: server.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the epoll event loop behind multi-lookup -d.
+ *      All socket I/O happens on the loop thread. Resolver threads only
+ *      append answers to a connection's buffer, put it on the dirty
+ *      list and poke an eventfd. Since only the loop frees a
+ *      connection, and only once nothing is pending and it is off the
+ *      dirty list, resolvers never see a freed connection. A name the
+ *      submit function refuses stays in its connection's read buffer,
+ *      and the connection is not read again until all of that buffer
+ *      is submitted.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+
+#include "server.h"
+
+/* Set interest to events, adding or removing the fd as needed.
+ * Called with c->lock held. */
+static void conn_arm(server_conn* c, unsigned int events){
+    struct epoll_event ev;
+
+    if(events == c->events){
+	return;
+    }
+    ev.events = events;
+    ev.data.ptr = c;
+    if(events == 0){
+	epoll_ctl(c->srv->epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+    }
+    else if(c->events == 0){
+	epoll_ctl(c->srv->epollFd, EPOLL_CTL_ADD, c->fd, &ev);
+    }
+    else{
+	epoll_ctl(c->srv->epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+    }
+    c->events = events;
+}
+
+static void conn_free(server_conn* c){
+    server* s = c->srv;
+
+    if(c->prev){
+	c->prev->next = c->next;
+    }
+    else{
+	s->conns = c->next;
+    }
+    if(c->next){
+	c->next->prev = c->prev;
+    }
+    close(c->fd);
+    pthread_mutex_destroy(&c->lock);
+    free(c->out);
+    free(c);
+}
+
+/* Send as much buffered output as the socket takes, with c->lock held */
+static void conn_flush(server_conn* c){
+    size_t sent = 0;
+    ssize_t n;
+
+    while(sent < c->outLen && !c->dead){
+	n = send(c->fd, c->out + sent, c->outLen - sent,
+		 MSG_DONTWAIT | MSG_NOSIGNAL);
+	if(n < 0){
+	    if(errno == EINTR){
+		continue;
+	    }
+	    if(errno != EAGAIN && errno != EWOULDBLOCK){
+		c->dead = true;
+	    }
+	    break;
+	}
+	sent += n;
+    }
+    if(c->dead){
+	c->outLen = 0;
+    }
+    else if(sent){
+	memmove(c->out, c->out + sent, c->outLen - sent);
+	c->outLen -= sent;
+    }
+}
+
+/* Re-arm interest after any change, or free the connection when the
+ * session is over. Loop thread only. Returns true if freed. */
+static bool conn_update(server_conn* c){
+    unsigned int events = 0;
+    bool done;
+
+    pthread_mutex_lock(&c->lock);
+    done = (c->dead || (c->readClosed && c->outLen == 0 && c->readLen == 0))
+	&& c->pending == 0 && !c->dirty;
+    if(!done && !c->dead){
+	if(!c->readClosed && c->outLen < SERVER_OUT_HIGH && c->readLen == 0){
+	    events |= EPOLLIN;
+	}
+	if(c->outLen > 0){
+	    events |= EPOLLOUT;
+	}
+    }
+    conn_arm(c, events);
+    pthread_mutex_unlock(&c->lock);
+
+    if(done){
+	conn_free(c);
+    }
+    return done;
+}
+
+/* Offer one complete line to the submit function. Returns false if it
+ * had no room. */
+static bool conn_submit_line(server_conn* c){
+    server* s = c->srv;
+    int rv;
+
+    pthread_mutex_lock(&c->lock);
+    c->pending++;
+    pthread_mutex_unlock(&c->lock);
+    rv = s->submit(c->in, c, s->submitArg);
+    if(rv == SERVER_BUSY){
+	/* Flag first and ask again, room made before the flag was seen
+	 * would otherwise never wake the loop */
+	__atomic_store_n(&s->blocked, true, __ATOMIC_SEQ_CST);
+	rv = s->submit(c->in, c, s->submitArg);
+    }
+    if(rv == SERVER_BUSY){
+	pthread_mutex_lock(&c->lock);
+	c->pending--;
+	pthread_mutex_unlock(&c->lock);
+	s->holding = true;
+	return false;
+    }
+    return true;
+}
+
+/* Submit every complete line in the read buffer, stopping at the first
+ * one there is no room for. Returns true once the buffer is empty. */
+static bool conn_submit(server_conn* c){
+    while(c->readPos < c->readLen){
+	char ch = c->readBuf[c->readPos];
+	if(ch != '\n'){
+	    /* overlong lines are cut, the resolver will fail them */
+	    if(ch != '\r' && c->inLen < SERVER_LINE_MAX - 1){
+		c->in[c->inLen++] = ch;
+	    }
+	    c->readPos++;
+	    continue;
+	}
+	if(c->inLen > 0){
+	    c->in[c->inLen] = '\0';
+	    if(!conn_submit_line(c)){
+		/* readPos stays on the newline, the line is kept in in */
+		return false;
+	    }
+	    c->inLen = 0;
+	}
+	c->readPos++;
+    }
+    c->readPos = c->readLen = 0;
+    return true;
+}
+
+/* Read what is available and submit every complete line */
+static void conn_read(server_conn* c){
+    ssize_t n;
+
+    n = recv(c->fd, c->readBuf, sizeof(c->readBuf), MSG_DONTWAIT);
+    if(n == 0){
+	pthread_mutex_lock(&c->lock);
+	c->readClosed = true;
+	pthread_mutex_unlock(&c->lock);
+	/* a last name without a trailing newline ends at EOF, it goes
+	 * through the read buffer like any other in case it is refused */
+	if(c->inLen > 0){
+	    c->readBuf[0] = '\n';
+	    c->readPos = 0;
+	    c->readLen = 1;
+	    conn_submit(c);
+	}
+	return;
+    }
+    if(n < 0){
+	if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+	    pthread_mutex_lock(&c->lock);
+	    c->dead = true;
+	    pthread_mutex_unlock(&c->lock);
+	}
+	return;
+    }
+    c->readPos = 0;
+    c->readLen = n;
+    conn_submit(c);
+}
+
+/* The submit function has room again, hand on what connections are
+ * holding. Loop thread only. */
+static void resume_conns(server* s){
+    server_conn* c;
+    server_conn* next;
+
+    if(!s->holding){
+	return;
+    }
+    s->holding = false;
+    for(c=s->conns; c; c=next){
+	next = c->next;
+	if(c->readLen == 0){
+	    continue;
+	}
+	if(!c->dead){
+	    conn_submit(c);
+	}
+	conn_update(c);
+    }
+}
+
+static void accept_conns(server* s){
+    server_conn* c;
+    int fd;
+
+    while((fd = accept4(s->listenFd, NULL, NULL,
+			SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0){
+	c = calloc(1, sizeof(*c));
+	if(!c){
+	    perror("Error on server Malloc");
+	    close(fd);
+	    continue;
+	}
+	c->srv = s;
+	c->fd = fd;
+	pthread_mutex_init(&c->lock, NULL);
+	c->next = s->conns;
+	if(s->conns){
+	    s->conns->prev = c;
+	}
+	s->conns = c;
+
+	pthread_mutex_lock(&c->lock);
+	conn_arm(c, EPOLLIN);
+	pthread_mutex_unlock(&c->lock);
+    }
+}
+
+/* Take the dirty list and flush every connection on it */
+static void flush_dirty(server* s){
+    server_conn* list;
+    server_conn* c;
+    server_conn* next;
+
+    pthread_mutex_lock(&s->dirtyLock);
+    list = s->dirty;
+    s->dirty = NULL;
+    pthread_mutex_unlock(&s->dirtyLock);
+
+    for(c=list; c; c=next){
+	pthread_mutex_lock(&c->lock);
+	next = c->nextDirty;
+	c->nextDirty = NULL;
+	c->dirty = false;
+	conn_flush(c);
+	pthread_mutex_unlock(&c->lock);
+	conn_update(c);
+    }
+}
+
+static int add_fd(server* s, int fd, void* tag){
+    struct epoll_event ev;
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = tag;
+    return epoll_ctl(s->epollFd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int server_init(server* s, const char* path,
+		server_submit_fn submit, void* submitArg){
+    struct sockaddr_un addr;
+    sigset_t mask;
+
+    memset(s, 0, sizeof(*s));
+    s->listenFd = s->epollFd = s->eventFd = s->signalFd = -1;
+    s->path = path;
+    s->submit = submit;
+    s->submitArg = submitArg;
+    pthread_mutex_init(&s->dirtyLock, NULL);
+
+    if(strlen(path) >= sizeof(addr.sun_path)){
+	fprintf(stderr, "Socket path too long: %s\n", path);
+	return SERVER_FAILURE;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    /* A stale socket from an earlier run would make bind fail */
+    unlink(path);
+    s->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(s->listenFd < 0 ||
+       bind(s->listenFd, (struct sockaddr*)&addr, sizeof(addr)) ||
+       listen(s->listenFd, SOMAXCONN)){
+	perror("Error creating server socket");
+	return SERVER_FAILURE;
+    }
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    s->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    s->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    s->signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if(s->epollFd < 0 || s->eventFd < 0 || s->signalFd < 0 ||
+       add_fd(s, s->listenFd, &s->listenFd) ||
+       add_fd(s, s->eventFd, &s->eventFd) ||
+       add_fd(s, s->signalFd, &s->signalFd)){
+	perror("Error setting up server event loop");
+	return SERVER_FAILURE;
+    }
+
+    return SERVER_SUCCESS;
+}
+
+int server_run(server* s){
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    bool stop = false;
+    bool answers;
+    uint64_t count;
+    int n;
+    int i;
+
+    while(!stop){
+	n = epoll_wait(s->epollFd, events, SERVER_MAX_EVENTS, -1);
+	if(n < 0){
+	    if(errno == EINTR){
+		continue;
+	    }
+	    perror("Error waiting for server events");
+	    return SERVER_FAILURE;
+	}
+
+	answers = false;
+	for(i=0; i<n; i++){
+	    void* tag = events[i].data.ptr;
+	    server_conn* c;
+
+	    if(tag == &s->eventFd){
+		answers = true;
+		continue;
+	    }
+	    if(tag == &s->listenFd){
+		accept_conns(s);
+		continue;
+	    }
+	    if(tag == &s->signalFd){
+		struct signalfd_siginfo si;
+		if(read(s->signalFd, &si, sizeof(si)) == sizeof(si)){
+		    stop = true;
+		}
+		continue;
+	    }
+
+	    c = tag;
+	    if(events[i].events & (EPOLLERR | EPOLLHUP)){
+		pthread_mutex_lock(&c->lock);
+		c->dead = true;
+		c->outLen = 0;
+		pthread_mutex_unlock(&c->lock);
+	    }
+	    else{
+		if(events[i].events & EPOLLIN){
+		    conn_read(c);
+		}
+		if(events[i].events & EPOLLOUT){
+		    pthread_mutex_lock(&c->lock);
+		    conn_flush(c);
+		    pthread_mutex_unlock(&c->lock);
+		}
+	    }
+	    conn_update(c);
+	}
+
+	/* Last, since they may free connections listed in this batch.
+	 * The eventfd is drained first, so a wake that comes in while
+	 * they run is seen by the next epoll_wait. */
+	if(answers){
+	    if(read(s->eventFd, &count, sizeof(count)) < 0 && errno != EAGAIN){
+		perror("Error reading server eventfd");
+	    }
+	    resume_conns(s);
+	    flush_dirty(s);
+	}
+    }
+
+    return SERVER_SUCCESS;
+}
+
+void server_reply(server_conn* c, const char* line, size_t len){
+    server* s = c->srv;
+    uint64_t one = 1;
+    bool wake = false;
+
+    pthread_mutex_lock(&c->lock);
+    if(!c->dead){
+	if(c->outLen + len > c->outCap){
+	    size_t cap = c->outCap ? c->outCap * 2 : 4096;
+	    char* out;
+	    while(cap < c->outLen + len){
+		cap *= 2;
+	    }
+	    out = realloc(c->out, cap);
+	    if(out){
+		c->out = out;
+		c->outCap = cap;
+	    }
+	}
+	if(c->outLen + len <= c->outCap){
+	    memcpy(c->out + c->outLen, line, len);
+	    c->outLen += len;
+	}
+    }
+    c->pending--;
+    if(!c->dirty){
+	c->dirty = true;
+	pthread_mutex_lock(&s->dirtyLock);
+	c->nextDirty = s->dirty;
+	s->dirty = c;
+	pthread_mutex_unlock(&s->dirtyLock);
+	wake = true;
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    if(wake && write(s->eventFd, &one, sizeof(one)) < 0){
+	perror("Error waking server loop");
+    }
+}
+
+void server_resume(server* s){
+    uint64_t one = 1;
+
+    /* plain load first, so the common case stays a read */
+    if(!__atomic_load_n(&s->blocked, __ATOMIC_SEQ_CST) ||
+       !__atomic_exchange_n(&s->blocked, false, __ATOMIC_SEQ_CST)){
+	return;
+    }
+    if(write(s->eventFd, &one, sizeof(one)) < 0){
+	perror("Error waking server loop");
+    }
+}
+
+void server_cleanup(server* s){
+    while(s->conns){
+	conn_free(s->conns);
+    }
+    if(s->listenFd >= 0){
+	close(s->listenFd);
+	unlink(s->path);
+    }
+    if(s->epollFd >= 0){
+	close(s->epollFd);
+    }
+    if(s->eventFd >= 0){
+	close(s->eventFd);
+    }
+    if(s->signalFd >= 0){
+	close(s->signalFd);
+    }
+    pthread_mutex_destroy(&s->dirtyLock);
+}
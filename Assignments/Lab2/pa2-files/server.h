@@ -0,0 +1,110 @@
+/*
+ * File: server.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the unix domain socket front end of
+ *      multi-lookup -d. Clients write hostnames, one per line, as
+ *      many as they like without waiting, and read back one
+ *      "hostname,ip[,ip...]" line per name in completion order.
+ *      Shutting down the write side ends the session once every
+ *      answer has been sent. The loop never blocks handing names on:
+ *      when the submit function has no room, the rest of what a
+ *      client sent waits on its connection and the loop stops
+ *      reading from it until server_resume.
+ *
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SERVER_FAILURE -1
+#define SERVER_SUCCESS 0
+#define SERVER_BUSY 1          /* submit had no room, try the name later */
+
+#define SERVER_LINE_MAX 1025
+#define SERVER_MAX_EVENTS 64
+#define SERVER_READ_SIZE 16384
+/* stop reading a client whose unsent answers pass this many bytes */
+#define SERVER_OUT_HIGH (256 * 1024)
+
+struct server_s;
+
+typedef struct server_conn_s{
+    struct server_s* srv;
+    int fd;
+    pthread_mutex_t lock;       /* guards everything below */
+    char* out;                  /* answers not yet sent */
+    size_t outLen;
+    size_t outCap;
+    int pending;                /* names handed to resolvers, not answered */
+    bool readClosed;            /* client shut down its write side */
+    bool dead;                  /* socket error, answers are dropped */
+    bool dirty;                 /* on the server's dirty list */
+    unsigned int events;        /* epoll interest, 0 when removed */
+    struct server_conn_s* nextDirty;
+    struct server_conn_s* prev; /* all connections, loop thread only */
+    struct server_conn_s* next;
+    char in[SERVER_LINE_MAX];   /* partial request line, loop thread only */
+    size_t inLen;
+    char readBuf[SERVER_READ_SIZE]; /* last read, loop thread only */
+    size_t readPos;             /* up to here submitted */
+    size_t readLen;             /* 0 once all of it is submitted */
+} server_conn;
+
+/* Called from the event loop for every requested hostname, and must
+ * not block. Returns SERVER_SUCCESS once it took the name: the
+ * connection has one more pending name, which must be answered with
+ * server_reply exactly once, from any thread. Returns SERVER_BUSY
+ * when it has no room, and the loop offers the name again after
+ * server_resume. */
+typedef int (*server_submit_fn)(const char* hostname, server_conn* conn,
+				void* arg);
+
+typedef struct server_s{
+    int listenFd;
+    int epollFd;
+    int eventFd;                /* resolvers wake the loop through this */
+    int signalFd;               /* SIGINT and SIGTERM stop the loop */
+    const char* path;
+    server_submit_fn submit;
+    void* submitArg;
+    pthread_mutex_t dirtyLock;
+    server_conn* dirty;         /* connections with new answers */
+    server_conn* conns;
+    bool blocked;               /* a submit was refused, see server_resume */
+    bool holding;               /* connections hold refused names, loop only */
+} server;
+
+/* Function to bind and listen on path
+ * SIGINT and SIGTERM are blocked in the calling thread, so call it
+ * before creating resolver threads and they inherit the mask
+ * Returns SERVER_SUCCESS or SERVER_FAILURE
+ */
+int server_init(server* s, const char* path,
+		server_submit_fn submit, void* submitArg);
+
+/* Function to run the event loop until SIGINT or SIGTERM
+ * Returns SERVER_SUCCESS or SERVER_FAILURE
+ */
+int server_run(server* s);
+
+/* Function to queue one answer line (with its newline) and drop the
+ * connection's pending count. Safe from any thread. */
+void server_reply(server_conn* c, const char* line, size_t len);
+
+/* Function to tell the loop the submit function has room again, after
+ * taking work off whatever it submits to. Cheap when nothing is
+ * waiting. Safe from any thread. */
+void server_resume(server* s);
+
+/* Function to close every connection and the socket. Call once the
+ * resolvers have stopped, unanswered names are dropped. */
+void server_cleanup(server* s);
+
+#endif
@@ -0,0 +1,274 @@
+/*
+ * File: shmqueue.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains a bounded FIFO queue of strings kept in a
+ *      shm_open/memfd mapping. Blocking uses futexes on words inside
+ *      the mapping so waiters in other processes are woken directly.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "shmqueue.h"
+
+#define SHMQUEUE_MAGIC 0x53514d51
+
+static long futex(uint32_t* uaddr, int op, uint32_t val){
+    return syscall(SYS_futex, uaddr, op, val, NULL, NULL, 0);
+}
+
+/* Three state futex mutex (Drepper, "Futexes Are Tricky") */
+static void shm_lock(uint32_t* m){
+    uint32_t c = 0;
+
+    if(__atomic_compare_exchange_n(m, &c, 1, 0,
+				   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+	return;
+    }
+    if(c != 2){
+	c = __atomic_exchange_n(m, 2, __ATOMIC_ACQUIRE);
+    }
+    while(c != 0){
+	futex(m, FUTEX_WAIT, 2);
+	c = __atomic_exchange_n(m, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+static void shm_unlock(uint32_t* m){
+    if(__atomic_fetch_sub(m, 1, __ATOMIC_RELEASE) != 1){
+	__atomic_store_n(m, 0, __ATOMIC_RELEASE);
+	futex(m, FUTEX_WAKE, 1);
+    }
+}
+
+/* Drop the lock and sleep until *word moves past seq */
+static void shm_wait(shmqueue_header* h, uint32_t* word, uint32_t* waiters){
+    uint32_t seq = *word;
+
+    (*waiters)++;
+    shm_unlock(&h->lock);
+    futex(word, FUTEX_WAIT, seq);
+    shm_lock(&h->lock);
+    (*waiters)--;
+}
+
+static void shm_wake(uint32_t* word, int n){
+    __atomic_add_fetch(word, 1, __ATOMIC_RELEASE);
+    futex(word, FUTEX_WAKE, n);
+}
+
+/* End of stream, called with the lock held */
+static int shm_ended(shmqueue_header* h){
+    if(h->producers > 0){
+	return 0;
+    }
+    if(h->expected){
+	return h->finished >= h->expected;
+    }
+    return h->hadProducer;
+}
+
+static int shmqueue_map(shmqueue* q, int fd, size_t mapSize){
+    q->hdr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(q->hdr == MAP_FAILED){
+	perror("Error mapping shared queue");
+	q->hdr = NULL;
+	return QUEUE_FAILURE;
+    }
+    q->slots = (char*)q->hdr + sizeof(shmqueue_header);
+    q->mapSize = mapSize;
+    q->fd = fd;
+    return QUEUE_SUCCESS;
+}
+
+int shmqueue_create(shmqueue* q, const char* name, int size){
+    int fd;
+    size_t mapSize;
+
+    /* user specified size or default */
+    if(size <= 0){
+	size = QUEUEMAXSIZE;
+    }
+    mapSize = sizeof(shmqueue_header) + (size_t)size * SHMQUEUE_SLOTSIZE;
+
+    if(name){
+	fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    else{
+	fd = memfd_create("shmqueue", 0);
+    }
+    if(fd < 0){
+	perror("Error creating shared queue");
+	return QUEUE_FAILURE;
+    }
+    if(ftruncate(fd, mapSize)){
+	perror("Error sizing shared queue");
+	close(fd);
+	return QUEUE_FAILURE;
+    }
+    if(shmqueue_map(q, fd, mapSize) == QUEUE_FAILURE){
+	close(fd);
+	return QUEUE_FAILURE;
+    }
+
+    /* Fresh mapping is zero filled, so only the geometry needs
+     * setting. magic goes last so attachers never see a half
+     * initialized header. */
+    q->hdr->maxSize = size;
+    q->hdr->slotSize = SHMQUEUE_SLOTSIZE;
+    __atomic_store_n(&q->hdr->magic, SHMQUEUE_MAGIC, __ATOMIC_RELEASE);
+
+    return size;
+}
+
+int shmqueue_attach_fd(shmqueue* q, int fd){
+    struct stat st;
+    shmqueue_header* h;
+
+    if(fstat(fd, &st) || (size_t)st.st_size < sizeof(shmqueue_header)){
+	fprintf(stderr, "Error attaching shared queue: bad mapping\n");
+	return QUEUE_FAILURE;
+    }
+    if(shmqueue_map(q, fd, st.st_size) == QUEUE_FAILURE){
+	return QUEUE_FAILURE;
+    }
+    h = q->hdr;
+    if(__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != SHMQUEUE_MAGIC ||
+       h->slotSize != SHMQUEUE_SLOTSIZE ||
+       sizeof(shmqueue_header) + (size_t)h->maxSize * h->slotSize > q->mapSize){
+	fprintf(stderr, "Error attaching shared queue: bad header\n");
+	munmap(q->hdr, q->mapSize);
+	q->hdr = NULL;
+	return QUEUE_FAILURE;
+    }
+
+    return h->maxSize;
+}
+
+int shmqueue_attach(shmqueue* q, const char* name){
+    int fd;
+    int rv;
+
+    fd = shm_open(name, O_RDWR, 0);
+    if(fd < 0){
+	perror("Error opening shared queue");
+	return QUEUE_FAILURE;
+    }
+    rv = shmqueue_attach_fd(q, fd);
+    if(rv == QUEUE_FAILURE){
+	close(fd);
+    }
+    return rv;
+}
+
+void shmqueue_add_producer(shmqueue* q){
+    shmqueue_header* h = q->hdr;
+
+    shm_lock(&h->lock);
+    h->producers++;
+    h->hadProducer = 1;
+    shm_unlock(&h->lock);
+}
+
+void shmqueue_expect_producers(shmqueue* q, int n){
+    shmqueue_header* h = q->hdr;
+
+    shm_lock(&h->lock);
+    h->expected = n > 0 ? n : 0;
+    shm_unlock(&h->lock);
+}
+
+void shmqueue_remove_producer(shmqueue* q){
+    shmqueue_header* h = q->hdr;
+    int last;
+
+    shm_lock(&h->lock);
+    h->producers--;
+    h->finished++;
+    last = shm_ended(h);
+    shm_unlock(&h->lock);
+
+    /* Consumers blocked on an empty queue must see the end of stream */
+    if(last){
+	shm_wake(&h->notEmpty, INT32_MAX);
+    }
+}
+
+int shmqueue_push(shmqueue* q, const char* payload){
+    shmqueue_header* h = q->hdr;
+    size_t len = strlen(payload);
+    int wake;
+
+    if(len >= h->slotSize){
+	return QUEUE_FAILURE;
+    }
+
+    shm_lock(&h->lock);
+    while(h->count == h->maxSize){
+	shm_wait(h, &h->notFull, &h->fullWaiters);
+    }
+    memcpy(q->slots + (size_t)h->rear * h->slotSize, payload, len + 1);
+    h->rear = (h->rear + 1) % h->maxSize;
+    h->count++;
+    wake = (h->emptyWaiters > 0);
+    shm_unlock(&h->lock);
+
+    if(wake){
+	shm_wake(&h->notEmpty, 1);
+    }
+    return QUEUE_SUCCESS;
+}
+
+int shmqueue_pop(shmqueue* q, char* buf, size_t bufSize){
+    shmqueue_header* h = q->hdr;
+    int wake;
+
+    shm_lock(&h->lock);
+    while(h->count == 0){
+	if(shm_ended(h)){
+	    shm_unlock(&h->lock);
+	    return QUEUE_FAILURE;
+	}
+	shm_wait(h, &h->notEmpty, &h->emptyWaiters);
+    }
+    strncpy(buf, q->slots + (size_t)h->front * h->slotSize, bufSize);
+    buf[bufSize-1] = '\0';
+    h->front = (h->front + 1) % h->maxSize;
+    h->count--;
+    wake = (h->fullWaiters > 0);
+    shm_unlock(&h->lock);
+
+    if(wake){
+	shm_wake(&h->notFull, 1);
+    }
+    return QUEUE_SUCCESS;
+}
+
+void shmqueue_detach(shmqueue* q){
+    if(q->hdr){
+	munmap(q->hdr, q->mapSize);
+	q->hdr = NULL;
+    }
+    if(q->fd >= 0){
+	close(q->fd);
+	q->fd = -1;
+    }
+}
+
+int shmqueue_unlink(const char* name){
+    return shm_unlink(name);
+}
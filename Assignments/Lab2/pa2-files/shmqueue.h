@@ -0,0 +1,103 @@
+/*
+ * File: shmqueue.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for a bounded FIFO queue that lives in
+ *      a shared memory mapping so that independent processes can
+ *      attach to it as producers or consumers.
+ *
+ */
+
+#ifndef SHMQUEUE_H
+#define SHMQUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "queue.h"
+
+/* Size of one slot, large enough for a hostname or a result line */
+#define SHMQUEUE_SLOTSIZE 2048
+
+/* Shared state at the start of the mapping. Every field is only
+ * touched while holding lock, except the futex words which the
+ * kernel reads when sleeping. */
+typedef struct shmqueue_header_s{
+    uint32_t magic;
+    uint32_t maxSize;
+    uint32_t slotSize;
+    uint32_t lock;          /* futex mutex: 0 free, 1 locked, 2 contended */
+    uint32_t notEmpty;      /* futex word bumped on every push */
+    uint32_t notFull;       /* futex word bumped on every pop */
+    uint32_t emptyWaiters;
+    uint32_t fullWaiters;
+    uint32_t front;
+    uint32_t rear;
+    uint32_t count;
+    uint32_t producers;     /* currently attached producers */
+    uint32_t hadProducer;   /* set once the first producer attaches */
+    uint32_t expected;      /* producers to wait for, 0 for any */
+    uint32_t finished;      /* producers that have left */
+} shmqueue_header;
+
+typedef struct shmqueue_s{
+    shmqueue_header* hdr;
+    char* slots;
+    size_t mapSize;
+    int fd;
+} shmqueue;
+
+/* Function to create a new shared queue
+ * name is a shm_open name ("/foo"), or NULL for an anonymous
+ * memfd that can be shared with children or over a unix socket
+ * On success, returns queue size
+ * On failure, returns QUEUE_FAILURE
+ */
+int shmqueue_create(shmqueue* q, const char* name, int size);
+
+/* Function to attach to a queue created by another process
+ * On success, returns queue size
+ * On failure, returns QUEUE_FAILURE
+ */
+int shmqueue_attach(shmqueue* q, const char* name);
+
+/* Same as shmqueue_attach, for a memfd or shm descriptor */
+int shmqueue_attach_fd(shmqueue* q, int fd);
+
+/* Functions to register and unregister as a producer
+ * Consumers see the end of the stream once no producer is attached
+ * and at least one producer has left, or expected have left when
+ * shmqueue_expect_producers set a count
+ */
+void shmqueue_add_producer(shmqueue* q);
+void shmqueue_remove_producer(shmqueue* q);
+
+/* Function to tell consumers how many producers make up the whole
+ * stream, so one that finishes before the next attaches does not end
+ * it. Call it right after shmqueue_create.
+ */
+void shmqueue_expect_producers(shmqueue* q, int n);
+
+/* Function to copy a string into the queue, blocking while full
+ * Returns QUEUE_SUCCESS if the push succeeds.
+ * Returns QUEUE_FAILURE if the payload does not fit in a slot
+ */
+int shmqueue_push(shmqueue* q, const char* payload);
+
+/* Function to copy the oldest string out of the queue, blocking
+ * while empty
+ * Returns QUEUE_SUCCESS if a payload was copied to buf
+ * Returns QUEUE_FAILURE once the queue is empty and the stream has
+ * ended
+ */
+int shmqueue_pop(shmqueue* q, char* buf, size_t bufSize);
+
+/* Function to unmap the queue from this process */
+void shmqueue_detach(shmqueue* q);
+
+/* Function to remove a named queue, mapped copies stay valid */
+int shmqueue_unlink(const char* name);
+
+#endif
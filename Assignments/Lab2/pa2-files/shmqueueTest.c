@@ -0,0 +1,174 @@
+/*
+ * File: shmqueueTest.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains test code for the shared memory queue.
+ *      A forked child attaches as the consumer while the parent
+ *      pushes through a queue much smaller than the test size, so
+ *      both the full and the empty futex waits get exercised.
+ *      A second queue expects two producers that never overlap, and
+ *      the consumer has to read past the first one leaving.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "shmqueue.h"
+
+#define TEST_SIZE 1000
+#define QUEUE_SIZE 4
+
+int main(int argc, char* argv[]){
+
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    shmqueue q;
+    char payload[SHMQUEUE_SLOTSIZE];
+    char expected[SHMQUEUE_SLOTSIZE];
+    char big[SHMQUEUE_SLOTSIZE + 1];
+    int i;
+    int status;
+    int errors = 0;
+    pid_t pid;
+
+    /* Initialize anonymous queue, shared with the child by fork */
+    if(shmqueue_create(&q, NULL, QUEUE_SIZE) == QUEUE_FAILURE){
+	fprintf(stderr,
+		"error: shmqueue_create failed!\n");
+	return EXIT_FAILURE;
+    }
+
+    /* Test that oversized payloads are rejected */
+    memset(big, 'a', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    if(shmqueue_push(&q, big) != QUEUE_FAILURE){
+	fprintf(stderr,
+		"error: shmqueue_push accepted an oversized payload\n");
+	errors++;
+    }
+
+    shmqueue_add_producer(&q);
+
+    pid = fork();
+    if(pid < 0){
+	perror("fork");
+	return EXIT_FAILURE;
+    }
+    if(pid == 0){
+	/* Consumer: check FIFO order, then end of stream */
+	for(i=0; i<TEST_SIZE; i++){
+	    snprintf(expected, sizeof(expected), "host%d.example.com", i);
+	    if(shmqueue_pop(&q, payload, sizeof(payload)) == QUEUE_FAILURE){
+		fprintf(stderr,
+			"error: shmqueue_pop failed!\n"
+			"Payload Index: %d\n", i);
+		_exit(EXIT_FAILURE);
+	    }
+	    if(strcmp(payload, expected)){
+		fprintf(stderr,
+			"error: push/pop mismatch!\n"
+			"Payload Index: %d, "
+			"Expected: %s, "
+			"Output: %s\n",
+			i, expected, payload);
+		_exit(EXIT_FAILURE);
+	    }
+	}
+	if(shmqueue_pop(&q, payload, sizeof(payload)) != QUEUE_FAILURE){
+	    fprintf(stderr,
+		    "error: shmqueue_pop did not report"
+		    " end of stream!\n");
+	    _exit(EXIT_FAILURE);
+	}
+	shmqueue_detach(&q);
+	_exit(EXIT_SUCCESS);
+    }
+
+    /* Producer */
+    for(i=0; i<TEST_SIZE; i++){
+	snprintf(payload, sizeof(payload), "host%d.example.com", i);
+	if(shmqueue_push(&q, payload) == QUEUE_FAILURE){
+	    fprintf(stderr,
+		    "error: shmqueue_push failed!\n"
+		    "Payload Index: %d\n", i);
+	    errors++;
+	}
+    }
+    shmqueue_remove_producer(&q);
+
+    if(waitpid(pid, &status, 0) < 0 ||
+       !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS){
+	fprintf(stderr,
+		"error: consumer process failed\n");
+	errors++;
+    }
+
+    /* Cleanup Queue */
+    shmqueue_detach(&q);
+
+    /* Two producers one after the other, the stream ends with both */
+    if(shmqueue_create(&q, NULL, QUEUE_SIZE) == QUEUE_FAILURE){
+	fprintf(stderr,
+		"error: shmqueue_create failed!\n");
+	return EXIT_FAILURE;
+    }
+    shmqueue_expect_producers(&q, 2);
+
+    pid = fork();
+    if(pid < 0){
+	perror("fork");
+	return EXIT_FAILURE;
+    }
+    if(pid == 0){
+	for(i=0; i<2; i++){
+	    snprintf(expected, sizeof(expected), "producer%d", i);
+	    if(shmqueue_pop(&q, payload, sizeof(payload)) == QUEUE_FAILURE ||
+	       strcmp(payload, expected)){
+		fprintf(stderr,
+			"error: stream ended before producer %d\n", i);
+		_exit(EXIT_FAILURE);
+	    }
+	}
+	if(shmqueue_pop(&q, payload, sizeof(payload)) != QUEUE_FAILURE){
+	    fprintf(stderr,
+		    "error: shmqueue_pop did not report"
+		    " end of stream after both producers!\n");
+	    _exit(EXIT_FAILURE);
+	}
+	shmqueue_detach(&q);
+	_exit(EXIT_SUCCESS);
+    }
+
+    for(i=0; i<2; i++){
+	shmqueue_add_producer(&q);
+	snprintf(payload, sizeof(payload), "producer%d", i);
+	if(shmqueue_push(&q, payload) == QUEUE_FAILURE){
+	    fprintf(stderr,
+		    "error: shmqueue_push failed!\n");
+	    errors++;
+	}
+	shmqueue_remove_producer(&q);
+	/* give the consumer the chance to see nobody attached */
+	usleep(10000);
+    }
+
+    if(waitpid(pid, &status, 0) < 0 ||
+       !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS){
+	fprintf(stderr,
+		"error: consumer process failed\n");
+	errors++;
+    }
+    shmqueue_detach(&q);
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
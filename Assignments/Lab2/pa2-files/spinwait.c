@@ -0,0 +1,82 @@
+/*
+ * File: spinwait.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains an adaptive spin-then-park helper for the
+ *      bounded buffer in multi-lookup.
+ *
+ */
+
+#include "spinwait.h"
+
+static inline void cpu_relax(void){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+void spinwait_init(spinwait* sw, bool enabled){
+    sw->budget = SPINWAIT_MIN_BUDGET * 4;
+    sw->enabled = enabled;
+}
+
+/* Move the budget toward twice the spin a successful wait needed,
+ * or shrink it when spinning did not pay off. Racy updates from
+ * several threads only blur the average, so relaxed atomics do. */
+static void spinwait_update(spinwait* sw, unsigned int spun, bool success){
+    unsigned int budget = __atomic_load_n(&sw->budget, __ATOMIC_RELAXED);
+
+    if(success){
+	budget += ((int)(2 * spun) - (int)budget) / 8;
+    }
+    else{
+	budget -= budget / 4;
+    }
+    if(budget < SPINWAIT_MIN_BUDGET){
+	budget = SPINWAIT_MIN_BUDGET;
+    }
+    if(budget > SPINWAIT_MAX_BUDGET){
+	budget = SPINWAIT_MAX_BUDGET;
+    }
+    __atomic_store_n(&sw->budget, budget, __ATOMIC_RELAXED);
+}
+
+bool spinwait_until(spinwait* sw, pthread_mutex_t* mutex,
+		    bool (*ready)(void*), void* arg){
+    unsigned int budget;
+    unsigned int spun = 0;
+    unsigned int backoff = 1;
+    unsigned int i;
+
+    if(!sw->enabled){
+	return false;
+    }
+
+    budget = __atomic_load_n(&sw->budget, __ATOMIC_RELAXED);
+    while(spun < budget){
+	for(i=0; i<backoff; i++){
+	    cpu_relax();
+	}
+	spun += backoff;
+	if(backoff < SPINWAIT_MAX_BACKOFF){
+	    backoff <<= 1;
+	}
+
+	if(pthread_mutex_trylock(mutex) == 0){
+	    if(ready(arg)){
+		spinwait_update(sw, spun, true);
+		return true;
+	    }
+	    pthread_mutex_unlock(mutex);
+	}
+    }
+
+    spinwait_update(sw, spun, false);
+    return false;
+}
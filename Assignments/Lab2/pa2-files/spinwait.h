@@ -0,0 +1,42 @@
+/*
+ * File: spinwait.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for an adaptive spin-then-park helper.
+ *      A waiter polls with pause and exponential backoff for a while
+ *      before falling back to a condition variable. The spin budget
+ *      follows how long recent waits actually took.
+ *
+ */
+
+#ifndef SPINWAIT_H
+#define SPINWAIT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+/* Bounds on the number of pause instructions spent before parking */
+#define SPINWAIT_MIN_BUDGET 64
+#define SPINWAIT_MAX_BUDGET 16384
+#define SPINWAIT_MAX_BACKOFF 256
+
+typedef struct spinwait_s{
+    unsigned int budget;    /* current spin budget, in pauses */
+    bool enabled;           /* false on one cpu, spinning only delays the waker */
+} spinwait;
+
+/* Function to initialize a spin policy, shared by threads of one role */
+void spinwait_init(spinwait* sw, bool enabled);
+
+/* Function to spin until ready(arg) holds
+ * ready is probed with mutex held (taken with trylock)
+ * Returns true with mutex held once ready(arg) is true
+ * Returns false without mutex once the budget is spent, the caller
+ * then locks and parks on its condition variable as usual
+ */
+bool spinwait_until(spinwait* sw, pthread_mutex_t* mutex,
+		    bool (*ready)(void*), void* arg);
+
+#endif
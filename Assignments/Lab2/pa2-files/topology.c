@@ -0,0 +1,296 @@
+/*
+ * File: topology.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the sysfs topology reader and placement
+ *      policies for multi-lookup -a.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "topology.h"
+
+int topology_policy(const char* name){
+    if(!strcmp(name, "none")){
+	return TOPOLOGY_NONE;
+    }
+    if(!strcmp(name, "compact")){
+	return TOPOLOGY_COMPACT;
+    }
+    if(!strcmp(name, "spread")){
+	return TOPOLOGY_SPREAD;
+    }
+    if(!strcmp(name, "isolate")){
+	return TOPOLOGY_ISOLATE;
+    }
+    return TOPOLOGY_FAILURE;
+}
+
+/* Read a cpu list like "0-3,8-11" from a sysfs file
+ * Returns TOPOLOGY_SUCCESS or TOPOLOGY_FAILURE if it is not there
+ */
+static int read_cpulist(const char* path, cpu_set_t* set){
+    FILE* fp;
+    char buf[4096];
+    char* p;
+    char* save;
+
+    CPU_ZERO(set);
+    fp = fopen(path, "r");
+    if(!fp){
+	return TOPOLOGY_FAILURE;
+    }
+    if(!fgets(buf, sizeof(buf), fp)){
+	fclose(fp);
+	return TOPOLOGY_FAILURE;
+    }
+    fclose(fp);
+
+    for(p=strtok_r(buf, ",\n", &save); p; p=strtok_r(NULL, ",\n", &save)){
+	char* end;
+	long lo = strtol(p, &end, 10);
+	long hi = lo;
+	long c;
+	if(end == p){
+	    continue;
+	}
+	if(*end == '-'){
+	    hi = strtol(end + 1, NULL, 10);
+	}
+	for(c=lo; c<=hi && c<CPU_SETSIZE; c++){
+	    CPU_SET(c, set);
+	}
+    }
+    return TOPOLOGY_SUCCESS;
+}
+
+static int read_int(const char* path){
+    FILE* fp = fopen(path, "r");
+    int v = -1;
+
+    if(fp){
+	if(fscanf(fp, "%d", &v) != 1){
+	    v = -1;
+	}
+	fclose(fp);
+    }
+    return v;
+}
+
+/* The cpus sharing cpu's last level cache: the highest level data or
+ * unified cache listed under cache/indexN */
+static int llc_of(int cpu, cpu_set_t* set){
+    char path[256];
+    char type[32];
+    int best = -1;
+    int i;
+
+    for(i=0; ; i++){
+	FILE* fp;
+	int level;
+
+	snprintf(path, sizeof(path), TOPOLOGY_SYSFS "/cpu%d/cache/index%d/level",
+		 cpu, i);
+	level = read_int(path);
+	if(level < 0){
+	    break;
+	}
+	snprintf(path, sizeof(path), TOPOLOGY_SYSFS "/cpu%d/cache/index%d/type",
+		 cpu, i);
+	fp = fopen(path, "r");
+	type[0] = '\0';
+	if(fp){
+	    if(!fgets(type, sizeof(type), fp)){
+		type[0] = '\0';
+	    }
+	    fclose(fp);
+	}
+	if(!strncmp(type, "Instruction", 11) || level <= best){
+	    continue;
+	}
+	snprintf(path, sizeof(path),
+		 TOPOLOGY_SYSFS "/cpu%d/cache/index%d/shared_cpu_list", cpu, i);
+	if(read_cpulist(path, set) == TOPOLOGY_SUCCESS){
+	    best = level;
+	}
+    }
+    return best < 0 ? TOPOLOGY_FAILURE : TOPOLOGY_SUCCESS;
+}
+
+int topology_init(topology* t, int policy){
+    char path[256];
+    cpu_set_t llc;
+    int cpu;
+    int last = -1;
+    int i;
+
+    memset(t, 0, sizeof(*t));
+    t->policy = policy;
+    if(policy == TOPOLOGY_NONE){
+	return TOPOLOGY_SUCCESS;
+    }
+    if(sched_getaffinity(0, sizeof(t->usable), &t->usable)){
+	perror("Error reading cpu affinity");
+	return TOPOLOGY_FAILURE;
+    }
+    t->ncpus = CPU_COUNT(&t->usable);
+
+    /* group usable cpus by the cache they share */
+    for(cpu=0; cpu<CPU_SETSIZE; cpu++){
+	if(!CPU_ISSET(cpu, &t->usable)){
+	    continue;
+	}
+	last = cpu;
+	if(llc_of(cpu, &llc) == TOPOLOGY_FAILURE){
+	    llc = t->usable;
+	}
+	CPU_AND(&llc, &llc, &t->usable);
+	CPU_SET(cpu, &llc);
+	for(i=0; i<t->ndomains; i++){
+	    if(CPU_ISSET(cpu, &t->domains[i])){
+		break;
+	    }
+	}
+	if(i < t->ndomains){
+	    continue;
+	}
+	if(t->ndomains == TOPOLOGY_MAX_DOMAINS){
+	    /* fold the rest into the last domain */
+	    CPU_OR(&t->domains[i-1], &t->domains[i-1], &llc);
+	    continue;
+	}
+	t->domains[t->ndomains++] = llc;
+    }
+    for(i=1; i<t->ndomains; i++){
+	if(CPU_COUNT(&t->domains[i]) > CPU_COUNT(&t->domains[t->biggest])){
+	    t->biggest = i;
+	}
+    }
+
+    /* the writer gets the last usable core, with its hyperthreads */
+    CPU_ZERO(&t->writer);
+    if(last >= 0){
+	snprintf(path, sizeof(path),
+		 TOPOLOGY_SYSFS "/cpu%d/topology/thread_siblings_list", last);
+	if(read_cpulist(path, &t->writer) == TOPOLOGY_FAILURE){
+	    CPU_ZERO(&t->writer);
+	}
+	CPU_SET(last, &t->writer);
+	CPU_AND(&t->writer, &t->writer, &t->usable);
+    }
+    CPU_XOR(&t->rest, &t->usable, &t->writer);
+
+    if(policy == TOPOLOGY_ISOLATE && CPU_COUNT(&t->rest) == 0){
+	fprintf(stderr, "Only one core, -a isolate leaves threads unpinned\n");
+    }
+    return TOPOLOGY_SUCCESS;
+}
+
+int topology_cpus(const topology* t, int role, int index, cpu_set_t* set){
+    switch(t->policy){
+    case TOPOLOGY_COMPACT:
+	*set = t->domains[t->biggest];
+	return TOPOLOGY_SUCCESS;
+    case TOPOLOGY_SPREAD:
+	if(role == TOPOLOGY_WRITER){
+	    /* it takes results from every domain */
+	    return TOPOLOGY_FAILURE;
+	}
+	*set = t->domains[index % t->ndomains];
+	return TOPOLOGY_SUCCESS;
+    case TOPOLOGY_ISOLATE:
+	if(CPU_COUNT(&t->rest) == 0){
+	    return TOPOLOGY_FAILURE;
+	}
+	*set = role == TOPOLOGY_WRITER ? t->writer : t->rest;
+	return TOPOLOGY_SUCCESS;
+    default:
+	return TOPOLOGY_FAILURE;
+    }
+}
+
+int topology_attr(const topology* t, int role, int index, pthread_attr_t* attr){
+    cpu_set_t set;
+
+    if(pthread_attr_init(attr)){
+	return TOPOLOGY_FAILURE;
+    }
+    if(topology_cpus(t, role, index, &set) == TOPOLOGY_FAILURE){
+	return TOPOLOGY_FAILURE;
+    }
+    if(pthread_attr_setaffinity_np(attr, sizeof(set), &set)){
+	return TOPOLOGY_FAILURE;
+    }
+    return TOPOLOGY_SUCCESS;
+}
+
+int topology_pin(const topology* t, int role, int index, pthread_t thread){
+    cpu_set_t set;
+
+    if(topology_cpus(t, role, index, &set) == TOPOLOGY_FAILURE){
+	return TOPOLOGY_FAILURE;
+    }
+    if(pthread_setaffinity_np(thread, sizeof(set), &set)){
+	return TOPOLOGY_FAILURE;
+    }
+    return TOPOLOGY_SUCCESS;
+}
+
+static void print_set(const cpu_set_t* set, FILE* fp){
+    int cpu;
+    int lo = -1;
+    const char* sep = "";
+
+    for(cpu=0; cpu<=CPU_SETSIZE; cpu++){
+	bool in = cpu < CPU_SETSIZE && CPU_ISSET(cpu, set);
+	if(in && lo < 0){
+	    lo = cpu;
+	}
+	else if(!in && lo >= 0){
+	    if(cpu - 1 > lo){
+		fprintf(fp, "%s%d-%d", sep, lo, cpu - 1);
+	    }
+	    else{
+		fprintf(fp, "%s%d", sep, lo);
+	    }
+	    sep = ",";
+	    lo = -1;
+	}
+    }
+}
+
+void topology_print(const topology* t, FILE* fp){
+    static const char* roles[] = { "producers", "resolvers", "writer" };
+    cpu_set_t set;
+    int i;
+    int r;
+
+    fprintf(fp, "%d usable cpus, %d LLC domains:", t->ncpus, t->ndomains);
+    for(i=0; i<t->ndomains; i++){
+	fprintf(fp, " [");
+	print_set(&t->domains[i], fp);
+	fprintf(fp, "]");
+    }
+    fprintf(fp, "\n");
+    for(r=TOPOLOGY_PRODUCER; r<=TOPOLOGY_WRITER; r++){
+	fprintf(fp, "  %s:", roles[r]);
+	if(topology_cpus(t, r, 0, &set) == TOPOLOGY_FAILURE){
+	    fprintf(fp, " unpinned\n");
+	    continue;
+	}
+	fprintf(fp, " ");
+	print_set(&set, fp);
+	if(t->policy == TOPOLOGY_SPREAD && t->ndomains > 1){
+	    fprintf(fp, " (thread i on domain i %% %d)", t->ndomains);
+	}
+	fprintf(fp, "\n");
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * File: topology.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for thread placement in multi-lookup -a.
+ *      The CPU topology is read from sysfs: the cpus this process may
+ *      run on, which of them share a last level cache, and which are
+ *      hyperthreads of one core. A policy then gives each producer,
+ *      resolver and writer thread a set of cpus to run on.
+ *
+ *      TOPOLOGY_COMPACT  everything on the biggest LLC domain, so
+ *                        names and results stay in one cache
+ *      TOPOLOGY_SPREAD   thread i on domain i % domains, for the
+ *                        most cache and memory bandwidth in total
+ *      TOPOLOGY_ISOLATE  one core for the writer, producers and
+ *                        resolvers on every other cpu
+ *
+ *      Threads are pinned to a domain rather than to one cpu.
+ *      Resolvers spend most of their time blocked, and the scheduler
+ *      still balances them inside the domain.
+ *
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+/* cpu_set_t needs _GNU_SOURCE defined before the first include */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define TOPOLOGY_FAILURE -1
+#define TOPOLOGY_SUCCESS 0
+
+#define TOPOLOGY_MAX_DOMAINS 64
+#ifndef TOPOLOGY_SYSFS
+#define TOPOLOGY_SYSFS "/sys/devices/system/cpu"
+#endif
+
+/* placement policies */
+#define TOPOLOGY_NONE 0
+#define TOPOLOGY_COMPACT 1
+#define TOPOLOGY_SPREAD 2
+#define TOPOLOGY_ISOLATE 3
+
+/* thread roles */
+#define TOPOLOGY_PRODUCER 0
+#define TOPOLOGY_RESOLVER 1
+#define TOPOLOGY_WRITER 2
+
+typedef struct topology_s{
+    int policy;
+    cpu_set_t usable;           /* the affinity we started with */
+    int ncpus;
+    cpu_set_t domains[TOPOLOGY_MAX_DOMAINS]; /* usable cpus per LLC */
+    int ndomains;
+    int biggest;                /* domain with the most usable cpus */
+    cpu_set_t writer;           /* isolate: the last core, all its threads */
+    cpu_set_t rest;             /* isolate: every other usable cpu */
+} topology;
+
+/* Function to parse a policy name: compact, spread, isolate or none
+ * Returns the policy, or TOPOLOGY_FAILURE for an unknown name
+ */
+int topology_policy(const char* name);
+
+/* Function to read the topology from sysfs for policy. Without
+ * sysfs every usable cpu is taken as one domain, with
+ * TOPOLOGY_NONE nothing is read and no thread is pinned.
+ * Returns TOPOLOGY_SUCCESS or TOPOLOGY_FAILURE
+ */
+int topology_init(topology* t, int policy);
+
+/* Function to pick the cpus for the index-th thread of a role
+ * Returns TOPOLOGY_SUCCESS, or TOPOLOGY_FAILURE if the thread should
+ * be left where the scheduler puts it
+ */
+int topology_cpus(const topology* t, int role, int index, cpu_set_t* set);
+
+/* Function to set up attr for creating the index-th thread of a role.
+ * attr is initialized either way, destroy it after pthread_create.
+ * Returns TOPOLOGY_SUCCESS or TOPOLOGY_FAILURE
+ */
+int topology_attr(const topology* t, int role, int index, pthread_attr_t* attr);
+
+/* Function to move a thread that is already running
+ * Returns TOPOLOGY_SUCCESS or TOPOLOGY_FAILURE
+ */
+int topology_pin(const topology* t, int role, int index, pthread_t thread);
+
+/* Function to print the domains and what each role gets */
+void topology_print(const topology* t, FILE* fp);
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * File: uring.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains a minimal io_uring wrapper on the raw system
+ *      calls. The ring indices shared with the kernel are read with
+ *      acquire and written with release ordering.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "uring.h"
+
+static int sys_setup(unsigned entries, struct io_uring_params* p){
+    return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned submit, unsigned waitFor, unsigned flags){
+    return (int) syscall(__NR_io_uring_enter, fd, submit, waitFor, flags, NULL, 0);
+}
+
+static int sys_register(int fd, unsigned op, const void* arg, unsigned n){
+    return (int) syscall(__NR_io_uring_register, fd, op, arg, n);
+}
+
+int uring_init(uring* r, unsigned entries){
+    struct io_uring_params p;
+    char* sq;
+    char* cq;
+
+    memset(r, 0, sizeof(*r));
+    memset(&p, 0, sizeof(p));
+    r->fd = sys_setup(entries, &p);
+    if(r->fd < 0){
+	return URING_FAILURE;
+    }
+
+    r->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP){
+	if(r->cqRingSize > r->sqRingSize){
+	    r->sqRingSize = r->cqRingSize;
+	}
+	r->cqRingSize = r->sqRingSize;
+    }
+
+    r->sqRing = mmap(NULL, r->sqRingSize, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if(r->sqRing == MAP_FAILED){
+	close(r->fd);
+	return URING_FAILURE;
+    }
+    if(p.features & IORING_FEAT_SINGLE_MMAP){
+	r->cqRing = r->sqRing;
+    }
+    else{
+	r->cqRing = mmap(NULL, r->cqRingSize, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+	if(r->cqRing == MAP_FAILED){
+	    munmap(r->sqRing, r->sqRingSize);
+	    close(r->fd);
+	    return URING_FAILURE;
+	}
+    }
+    r->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqesSize, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if(r->sqes == MAP_FAILED){
+	if(r->cqRing != r->sqRing){
+	    munmap(r->cqRing, r->cqRingSize);
+	}
+	munmap(r->sqRing, r->sqRingSize);
+	close(r->fd);
+	return URING_FAILURE;
+    }
+
+    sq = r->sqRing;
+    cq = r->cqRing;
+    r->sqHead = (unsigned*)(sq + p.sq_off.head);
+    r->sqTail = (unsigned*)(sq + p.sq_off.tail);
+    r->sqMask = (unsigned*)(sq + p.sq_off.ring_mask);
+    r->sqArray = (unsigned*)(sq + p.sq_off.array);
+    r->sqEntries = p.sq_entries;
+    r->sqLocalTail = *r->sqTail;
+    r->cqHead = (unsigned*)(cq + p.cq_off.head);
+    r->cqTail = (unsigned*)(cq + p.cq_off.tail);
+    r->cqMask = (unsigned*)(cq + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    return URING_SUCCESS;
+}
+
+int uring_register_buffers(uring* r, const struct iovec* iov, unsigned n){
+    if(sys_register(r->fd, IORING_REGISTER_BUFFERS, iov, n) < 0){
+	return URING_FAILURE;
+    }
+    return URING_SUCCESS;
+}
+
+struct io_uring_sqe* uring_get_sqe(uring* r){
+    unsigned head = __atomic_load_n(r->sqHead, __ATOMIC_ACQUIRE);
+    struct io_uring_sqe* sqe;
+    unsigned idx;
+
+    if(r->sqLocalTail - head >= r->sqEntries){
+	return NULL;
+    }
+    idx = r->sqLocalTail & *r->sqMask;
+    sqe = &r->sqes[idx];
+    r->sqArray[idx] = idx;
+    r->sqLocalTail++;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int uring_submit(uring* r, unsigned waitFor){
+    unsigned tail = *r->sqTail;
+    unsigned submit = r->sqLocalTail - tail;
+    int rv;
+
+    /* publish the new entries before the kernel looks at the tail */
+    __atomic_store_n(r->sqTail, r->sqLocalTail, __ATOMIC_RELEASE);
+    if(submit == 0 && waitFor == 0){
+	return 0;
+    }
+    do{
+	rv = sys_enter(r->fd, submit, waitFor,
+		       waitFor ? IORING_ENTER_GETEVENTS : 0);
+    }while(rv < 0 && errno == EINTR);
+    if(rv < 0){
+	return URING_FAILURE;
+    }
+    return rv;
+}
+
+bool uring_next_cqe(uring* r, struct io_uring_cqe* cqe){
+    unsigned head = *r->cqHead;
+
+    if(head == __atomic_load_n(r->cqTail, __ATOMIC_ACQUIRE)){
+	return false;
+    }
+    *cqe = r->cqes[head & *r->cqMask];
+    __atomic_store_n(r->cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void uring_cleanup(uring* r){
+    munmap(r->sqes, r->sqesSize);
+    if(r->cqRing != r->sqRing){
+	munmap(r->cqRing, r->cqRingSize);
+    }
+    munmap(r->sqRing, r->sqRingSize);
+    close(r->fd);
+    r->fd = -1;
+}
@@ -0,0 +1,78 @@
+/*
+ * File: uring.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for a minimal io_uring wrapper built on
+ *      the raw system calls (there is no liburing on the lab machines).
+ *      One thread owns a ring: it fills submission entries, submits
+ *      them in batches and reaps completions.
+ *
+ */
+
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#define URING_FAILURE -1
+#define URING_SUCCESS 0
+
+typedef struct uring_s{
+    int fd;
+    /* submission ring */
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    struct io_uring_sqe* sqes;
+    unsigned sqEntries;
+    unsigned sqLocalTail;   /* entries handed out, not yet published */
+    /* completion ring */
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    struct io_uring_cqe* cqes;
+    /* mappings */
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;           /* same as sqRing with a single mmap */
+    size_t cqRingSize;
+    size_t sqesSize;
+} uring;
+
+/* Function to set up a ring with room for entries submissions
+ * Returns URING_FAILURE when the kernel has no io_uring (or it is
+ * disabled), so callers can fall back to plain system calls
+ */
+int uring_init(uring* r, unsigned entries);
+
+/* Function to register n buffers for READ_FIXED/WRITE_FIXED
+ * Returns URING_SUCCESS or URING_FAILURE (e.g. over RLIMIT_MEMLOCK)
+ */
+int uring_register_buffers(uring* r, const struct iovec* iov, unsigned n);
+
+/* Function to get a zeroed submission entry
+ * Returns NULL when the submission ring is full
+ */
+struct io_uring_sqe* uring_get_sqe(uring* r);
+
+/* Function to submit every entry handed out since the last call and
+ * wait until at least waitFor completions are available
+ * Returns the number submitted or URING_FAILURE
+ */
+int uring_submit(uring* r, unsigned waitFor);
+
+/* Function to take one completion, if there is one
+ * Returns true and fills *cqe, false when the ring is empty
+ */
+bool uring_next_cqe(uring* r, struct io_uring_cqe* cqe);
+
+/* Function to tear down the ring */
+void uring_cleanup(uring* r);
+
+#endif
@@ -4,75 +4,181 @@
  * Project: CSCI 3753 Programming Assignment 2
  * Create Date: 2012/02/01
  * Modify Date: 2012/02/01
+ * Modify Date: 2026/10/19
  * Description:
  * 	This file contains declarations of utility functions for
  *      Programming Assignment 2.
  *  
  */
 
+#include <ctype.h>
+
 #include "util.h"
 
-int dnslookup(const char* hostname, char* firstIPstr, int maxSize){
+/* Decimal text of every octet, with its length, so an IPv4 address
+ * formats as four fixed copies and no per-digit branches */
+static const char octetStr[256][4] = {
+#define O1(n) #n
+#define O10(t) O1(t##0), O1(t##1), O1(t##2), O1(t##3), O1(t##4), \
+	O1(t##5), O1(t##6), O1(t##7), O1(t##8), O1(t##9)
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+    O10(1), O10(2), O10(3), O10(4), O10(5), O10(6), O10(7), O10(8), O10(9),
+    O10(10), O10(11), O10(12), O10(13), O10(14), O10(15), O10(16), O10(17),
+    O10(18), O10(19), O10(20), O10(21), O10(22), O10(23), O10(24),
+    O1(250), O1(251), O1(252), O1(253), O1(254), O1(255)
+#undef O10
+#undef O1
+};
+
+static int ipv4_format(const unsigned char* a, char* out){
+    char* p = out;
+    int i;
+
+    for(i=0; i<4; i++){
+	/* copy all 4 bytes, advance by the real length, overwrite the
+	 * tail with the separator */
+	memcpy(p, octetStr[a[i]], 4);
+	p += 1 + (a[i] >= 10) + (a[i] >= 100);
+	*p++ = '.';
+    }
+    *--p = '\0';
+    return p - out;
+}
+
+static int ipv6_format(const unsigned char* a, char* out){
+    static const char hex[] = "0123456789abcdef";
+    unsigned int g[8];
+    int bestStart = -1;
+    int bestLen = 0;
+    int runStart = 0;
+    int runLen = 0;
+    char* p = out;
+    int i;
+
+    /* find the longest run of zero groups, RFC 5952 section 4.2 */
+    for(i=0; i<8; i++){
+	g[i] = (a[2*i] << 8) | a[2*i+1];
+	if(g[i] == 0){
+	    if(runLen == 0){
+		runStart = i;
+	    }
+	    runLen++;
+	    if(runLen > bestLen){
+		bestStart = runStart;
+		bestLen = runLen;
+	    }
+	}
+	else{
+	    runLen = 0;
+	}
+    }
+    if(bestLen < 2){
+	bestStart = -1;
+    }
+
+    /* IPv4-mapped (::ffff:0:0/96) and IPv4-compatible (::/96, but not
+     * :: or ::1 style addresses) end in a dotted quad, RFC 5952
+     * section 5, same as inet_ntop */
+    if(bestStart == 0 && (bestLen == 6 || (bestLen == 5 && g[5] == 0xffff))){
+	*p++ = ':';
+	*p++ = ':';
+	if(bestLen == 5){
+	    memcpy(p, "ffff:", 5);
+	    p += 5;
+	}
+	return (p - out) + ipv4_format(a + 12, p);
+    }
+
+    for(i=0; i<8; i++){
+	if(i == bestStart){
+	    *p++ = ':';
+	    if(i == 0){
+		*p++ = ':';
+	    }
+	    i += bestLen - 1;
+	    continue;
+	}
+	/* lowercase hex without leading zeros */
+	unsigned int v = g[i];
+	int digits = 1 + (v > 0xf) + (v > 0xff) + (v > 0xfff);
+	char tmp[4] = { hex[v >> 12], hex[(v >> 8) & 0xf],
+			hex[(v >> 4) & 0xf], hex[v & 0xf] };
+	memcpy(p, tmp + 4 - digits, digits);
+	p += digits;
+	if(i < 7){
+	    *p++ = ':';
+	}
+    }
+    *p = '\0';
+    return p - out;
+}
+
+int ip_format(const ip_addr_t* ip, char* out){
+    if(ip->family == AF_INET){
+	return ipv4_format(ip->addr, out);
+    }
+    return ipv6_format(ip->addr, out);
+}
+
+int dnslookup_all(const char* hostname, ip_list_t* ips){
 
     /* Local vars */
+    struct addrinfo hints;
     struct addrinfo* headresult = NULL;
     struct addrinfo* result = NULL;
-    struct sockaddr_in* ipv4sock = NULL;
-    struct in_addr* ipv4addr = NULL;
-    char ipv4str[INET_ADDRSTRLEN];
-    char ipstr[INET6_ADDRSTRLEN];
+    ip_addr_t ip;
     int addrError = 0;
+    int i;
 
     /* DEBUG: Print Hostname*/
 #ifdef UTIL_DEBUG
     fprintf(stderr, "%s\n", hostname);
 #endif
-   
+
+    /* One socket type, otherwise every address comes back once
+     * per stream/dgram/raw */
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
     /* Lookup Hostname */
-    addrError = getaddrinfo(hostname, NULL, NULL, &headresult);
+    ips->naddrs = 0;
+    addrError = getaddrinfo(hostname, NULL, &hints, &headresult);
     if(addrError){
 	fprintf(stderr, "Error looking up Address: %s\n",
 		gai_strerror(addrError));
-	return UTIL_FAILURE;
+	return addrError == EAI_AGAIN ? UTIL_TRYAGAIN : UTIL_FAILURE;
     }
-    /* Loop Through result Linked List */
+    /* Loop Through result Linked List, keeping binary addresses */
     for(result=headresult; result != NULL; result = result->ai_next){
-	/* Extract IP Address and Convert to String */
+	memset(&ip, 0, sizeof(ip));
 	if(result->ai_addr->sa_family == AF_INET){
 	    /* IPv4 Address Handling */
-	    ipv4sock = (struct sockaddr_in*)(result->ai_addr);
-	    ipv4addr = &(ipv4sock->sin_addr);
-	    if(!inet_ntop(result->ai_family, ipv4addr,
-			  ipv4str, sizeof(ipv4str))){
-		perror("Error Converting IP to String");
-		return UTIL_FAILURE;
-	    }
-#ifdef UTIL_DEBUG
-	    fprintf(stdout, "%s\n", ipv4str);
-#endif
-	    strncpy(ipstr, ipv4str, sizeof(ipstr));
-	    ipstr[sizeof(ipstr)-1] = '\0';
+	    ip.family = AF_INET;
+	    memcpy(ip.addr,
+		   &((struct sockaddr_in*)(result->ai_addr))->sin_addr, 4);
 	}
 	else if(result->ai_addr->sa_family == AF_INET6){
 	    /* IPv6 Handling */
-#ifdef UTIL_DEBUG
-	    fprintf(stdout, "IPv6 Address: Not Handled\n");
-#endif
-	    strncpy(ipstr, "UNHANDELED", sizeof(ipstr));
-	    ipstr[sizeof(ipstr)-1] = '\0';
+	    ip.family = AF_INET6;
+	    memcpy(ip.addr,
+		   &((struct sockaddr_in6*)(result->ai_addr))->sin6_addr, 16);
 	}
 	else{
 	    /* Unhandlded Protocol Handling */
 #ifdef UTIL_DEBUG
 	    fprintf(stdout, "Unknown Protocol: Not Handled\n");
 #endif
-	    strncpy(ipstr, "UNHANDELED", sizeof(ipstr));
-	    ipstr[sizeof(ipstr)-1] = '\0';
+	    continue;
+	}
+	/* Skip repeats */
+	for(i=0; i<ips->naddrs; i++){
+	    if(!memcmp(&ips->addrs[i], &ip, sizeof(ip))){
+		break;
+	    }
 	}
-	/* Save First IP Address */
-	if(result==headresult){
-	    strncpy(firstIPstr, ipstr, maxSize);
-	    firstIPstr[maxSize-1] = '\0';
+	if(i == ips->naddrs && ips->naddrs < UTIL_MAX_ADDRS){
+	    ips->addrs[ips->naddrs++] = ip;
 	}
     }
 
@@ -81,3 +187,103 @@ int dnslookup(const char* hostname, char* firstIPstr, int maxSize){
 
     return UTIL_SUCCESS;
 }
+
+int ip_parse(const char* text, ip_addr_t* ip){
+    memset(ip, 0, sizeof(*ip));
+    if(inet_pton(AF_INET, text, ip->addr) == 1){
+	ip->family = AF_INET;
+	return UTIL_SUCCESS;
+    }
+    if(inet_pton(AF_INET6, text, ip->addr) == 1){
+	ip->family = AF_INET6;
+	return UTIL_SUCCESS;
+    }
+    return UTIL_FAILURE;
+}
+
+int dnsreverse(const ip_addr_t* ip, char* name, int maxSize){
+
+    /* Local vars */
+    struct sockaddr_storage ss;
+    socklen_t sslen;
+    int nameError = 0;
+
+    memset(&ss, 0, sizeof(ss));
+    if(ip->family == AF_INET){
+	struct sockaddr_in* sin = (struct sockaddr_in*)&ss;
+	sin->sin_family = AF_INET;
+	memcpy(&sin->sin_addr, ip->addr, 4);
+	sslen = sizeof(*sin);
+    }
+    else{
+	struct sockaddr_in6* sin6 = (struct sockaddr_in6*)&ss;
+	sin6->sin6_family = AF_INET6;
+	memcpy(&sin6->sin6_addr, ip->addr, 16);
+	sslen = sizeof(*sin6);
+    }
+
+    /* Lookup Address, a name is required rather than the numeric
+     * form back */
+    nameError = getnameinfo((struct sockaddr*)&ss, sslen, name, maxSize,
+			    NULL, 0, NI_NAMEREQD);
+    if(nameError){
+	fprintf(stderr, "Error looking up Name: %s\n",
+		gai_strerror(nameError));
+	name[0] = '\0';
+	return nameError == EAI_AGAIN ? UTIL_TRYAGAIN : UTIL_FAILURE;
+    }
+
+    return UTIL_SUCCESS;
+}
+
+int dnslookup(const char* hostname, char* firstIPstr, int maxSize){
+
+    /* Local vars */
+    ip_list_t ips;
+    char ipstr[UTIL_ADDRSTRLEN];
+
+    if(dnslookup_all(hostname, &ips) != UTIL_SUCCESS){
+	return UTIL_FAILURE;
+    }
+
+    /* Save First IP Address */
+    if(ips.naddrs > 0){
+	ip_format(&ips.addrs[0], ipstr);
+    }
+    else{
+	strncpy(ipstr, "UNHANDELED", sizeof(ipstr));
+    }
+    strncpy(firstIPstr, ipstr, maxSize);
+    firstIPstr[maxSize-1] = '\0';
+
+    return UTIL_SUCCESS;
+}
+
+size_t name_normalize(const char* hostname, char* key, size_t keySize){
+    size_t len = 0;
+
+    while(hostname[len] && len < keySize - 1){
+	key[len] = tolower((unsigned char)hostname[len]);
+	len++;
+    }
+    while(len > 1 && key[len-1] == '.'){
+	len--;
+    }
+    key[len] = '\0';
+    return len;
+}
+
+/* FNV-1a with a final avalanche so the low bits are usable */
+uint64_t name_hash(const char* key, size_t len){
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i;
+
+    for(i=0; i<len; i++){
+	h ^= (unsigned char)key[i];
+	h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
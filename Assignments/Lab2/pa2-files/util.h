@@ -4,6 +4,7 @@
  * Project: CSCI 3753 Programming Assignment 2
  * Create Date: 2012/02/01
  * Modify Date: 2012/02/01
+ * Modify Date: 2026/10/19
  * Description:
  * 	This file contains declarations of utility functions for
  *      Programming Assignment 2.
@@ -20,6 +21,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
 
 #include <arpa/inet.h>
 #include <sys/types.h>
@@ -28,6 +30,54 @@
 
 #define UTIL_FAILURE -1
 #define UTIL_SUCCESS 0
+/* The resolver could not get an answer right now (SERVFAIL, REFUSED
+ * or a timeout upstream), the same lookup may work later */
+#define UTIL_TRYAGAIN -2
+
+/* Most addresses kept for one hostname */
+#define UTIL_MAX_ADDRS 16
+
+/* Buffer size for ip_format, big enough for any IPv6 address */
+#define UTIL_ADDRSTRLEN INET6_ADDRSTRLEN
+
+/* Binary IPv4 or IPv6 address, v4 uses the first 4 bytes */
+typedef struct ip_addr_s{
+    unsigned char family;       /* AF_INET or AF_INET6 */
+    unsigned char addr[16];
+} ip_addr_t;
+
+/* All addresses found for one hostname */
+typedef struct ip_list_s{
+    int naddrs;
+    ip_addr_t addrs[UTIL_MAX_ADDRS];
+} ip_list_t;
+
+/* Function to return every A and AAAA address found for hostname,
+ * in resolver order with duplicates removed. At most
+ * UTIL_MAX_ADDRS are kept.
+ * Returns UTIL_SUCCESS, UTIL_TRYAGAIN, or UTIL_FAILURE if the lookup
+ * failed for good
+ */
+int dnslookup_all(const char* hostname, ip_list_t* ips);
+
+/* Function to format an address as text (dotted quad, or RFC 5952
+ * compressed IPv6 with a dotted quad for IPv4-mapped and -compatible
+ * addresses, as inet_ntop prints them). out must hold UTIL_ADDRSTRLEN
+ * bytes.
+ * Returns the string length
+ */
+int ip_format(const ip_addr_t* ip, char* out);
+
+/* Function to parse an IPv4 or IPv6 address in text form
+ * Returns UTIL_SUCCESS, or UTIL_FAILURE if text is not an address
+ */
+int ip_parse(const char* text, ip_addr_t* ip);
+
+/* Function to find the name an address maps back to (its PTR
+ * record), into name of size maxSize
+ * Returns UTIL_SUCCESS, UTIL_TRYAGAIN, or UTIL_FAILURE if there is none
+ */
+int dnsreverse(const ip_addr_t* ip, char* name, int maxSize);
 
 /* Fuction to return the first IP address found
  * for hostname. IP address returned as string
@@ -37,4 +87,15 @@ int dnslookup(const char* hostname,
 	      char* firstIPstr,
 	      int maxSize);
 
+/* Function to put hostname in the form names are compared in:
+ * lowercase, trailing dots stripped, cut to fit key of size keySize
+ * Returns the normalized length
+ */
+size_t name_normalize(const char* hostname, char* key, size_t keySize);
+
+/* Function to hash a normalized name of length len
+ * Returns a 64 bit hash, every bit of it usable
+ */
+uint64_t name_hash(const char* key, size_t len);
+
 #endif
@@ -0,0 +1,122 @@
+/*
+ * File: utilTest.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains test code for ip_format. Every address,
+ *      the hand picked ones and a batch of random ones with plenty
+ *      of zero groups, has to come out exactly as inet_ntop prints
+ *      it and parse back to the same bytes.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "util.h"
+
+#define RANDOM_TESTS 100000
+
+static const char* fixedTests[] = {
+    "10.11.12.13",
+    "0.0.0.0",
+    "255.255.255.255",
+    "::ffff:10.11.12.13",       /* IPv4-mapped */
+    "::ffff:0.0.0.0",
+    "::ffff:0.0.0.1",
+    "::10.11.12.13",            /* IPv4-compatible */
+    "::0.1.0.0",
+    "::",
+    "::1",
+    "::2",
+    "::ffff",
+    "::ffff:0",
+    "::1:ffff:a0b:c0d",
+    "2001:db8::ffff:a0b:c0d",
+    "64:ff9b::a0b:c0d",
+    "2001:db8::1",
+    "2001:db8:0:1:1:1:1:1",
+    "fe80::",
+    NULL
+};
+
+/* Compare ip_format with inet_ntop for one address */
+static int check(const ip_addr_t* ip){
+    char expected[UTIL_ADDRSTRLEN];
+    char output[UTIL_ADDRSTRLEN];
+    ip_addr_t parsed;
+    int len;
+
+    inet_ntop(ip->family, ip->addr, expected, sizeof(expected));
+    len = ip_format(ip, output);
+    if(strcmp(output, expected) || len != (int)strlen(expected)){
+	fprintf(stderr,
+		"error: ip_format mismatch!\n"
+		"Expected: %s, "
+		"Output: %s (length %d)\n",
+		expected, output, len);
+	return 1;
+    }
+    if(ip_parse(output, &parsed) != UTIL_SUCCESS ||
+       parsed.family != ip->family ||
+       memcmp(parsed.addr, ip->addr, ip->family == AF_INET ? 4 : 16)){
+	fprintf(stderr,
+		"error: %s does not parse back to the same address\n",
+		output);
+	return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    ip_addr_t ip;
+    int errors = 0;
+    int i;
+    int j;
+
+    /* Hand picked, around the mixed notation cases */
+    for(i=0; fixedTests[i]; i++){
+	if(ip_parse(fixedTests[i], &ip) != UTIL_SUCCESS){
+	    fprintf(stderr,
+		    "error: ip_parse failed on %s\n", fixedTests[i]);
+	    errors++;
+	    continue;
+	}
+	errors += check(&ip);
+    }
+
+    /* Random IPv6, each group zero half the time so zero runs of
+     * every length and position come up, and the mapped prefix now
+     * and then */
+    srand(3753);
+    for(i=0; i<RANDOM_TESTS; i++){
+	memset(&ip, 0, sizeof(ip));
+	ip.family = AF_INET6;
+	for(j=0; j<8; j++){
+	    if(rand() % 2){
+		ip.addr[2*j] = rand() % 3 ? 0 : rand();
+		ip.addr[2*j+1] = rand();
+	    }
+	}
+	if(rand() % 8 == 0){
+	    memset(ip.addr, 0, 10);
+	    ip.addr[10] = ip.addr[11] = 0xff;
+	}
+	errors += check(&ip);
+    }
+
+    if(errors){
+	fprintf(stderr, "%d addresses failed\n", errors);
+	return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*
+ * File: worklist.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the shared input file list for the
+ *      multi-lookup producer pool.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "worklist.h"
+
+int worklist_init(worklist* w){
+    memset(w, 0, sizeof(*w));
+    if(pthread_mutex_init(&w->lock, NULL)){
+	return WORKLIST_FAILURE;
+    }
+    return WORKLIST_SUCCESS;
+}
+
+static int push_path(worklist* w, const char* path){
+    if(w->count == w->cap){
+	size_t cap = w->cap ? w->cap * 2 : 64;
+	char** paths = realloc(w->paths, cap * sizeof(*paths));
+	if(!paths){
+	    perror("Error on worklist Malloc");
+	    return WORKLIST_FAILURE;
+	}
+	w->paths = paths;
+	w->cap = cap;
+    }
+    w->paths[w->count] = strdup(path);
+    if(!w->paths[w->count]){
+	perror("Error on worklist Malloc");
+	return WORKLIST_FAILURE;
+    }
+    w->count++;
+    return 1;
+}
+
+static int cmp_names(const void* a, const void* b){
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/* Add every file under dir, in name order so runs are repeatable */
+static int add_dir(worklist* w, const char* dir){
+    DIR* d;
+    struct dirent* ent;
+    char** names = NULL;
+    size_t nnames = 0;
+    size_t cap = 0;
+    size_t i;
+    int added = 0;
+    int rv = 0;
+
+    d = opendir(dir);
+    if(!d){
+	perror(dir);
+	return WORKLIST_FAILURE;
+    }
+    while((ent = readdir(d)) != NULL){
+	if(!strcmp(ent->d_name, ".") || !strcmp(ent->d_name, "..")){
+	    continue;
+	}
+	if(nnames == cap){
+	    char** more;
+	    cap = cap ? cap * 2 : 64;
+	    more = realloc(names, cap * sizeof(*names));
+	    if(!more){
+		perror("Error on worklist Malloc");
+		rv = WORKLIST_FAILURE;
+		break;
+	    }
+	    names = more;
+	}
+	names[nnames] = strdup(ent->d_name);
+	if(!names[nnames]){
+	    rv = WORKLIST_FAILURE;
+	    break;
+	}
+	nnames++;
+    }
+    closedir(d);
+
+    if(rv != WORKLIST_FAILURE){
+	qsort(names, nnames, sizeof(*names), cmp_names);
+    }
+    for(i=0; i<nnames; i++){
+	if(rv != WORKLIST_FAILURE){
+	    size_t len = strlen(dir) + strlen(names[i]) + 2;
+	    char* path = malloc(len);
+	    if(!path){
+		rv = WORKLIST_FAILURE;
+	    }
+	    else{
+		struct stat st;
+		snprintf(path, len, "%s/%s", dir, names[i]);
+		/* skip sockets, FIFOs and the like inside directories, and
+		 * symlinks to directories, which can loop back up the tree */
+		if(lstat(path, &st) == 0){
+		    if(S_ISLNK(st.st_mode) && stat(path, &st) == 0 &&
+		       S_ISDIR(st.st_mode)){
+			rv = 0;
+		    }
+		    else if(S_ISDIR(st.st_mode)){
+			rv = add_dir(w, path);
+		    }
+		    else if(S_ISREG(st.st_mode)){
+			rv = push_path(w, path);
+		    }
+		    else{
+			rv = 0;
+		    }
+		    if(rv != WORKLIST_FAILURE){
+			added += rv;
+		    }
+		}
+		free(path);
+	    }
+	}
+	free(names[i]);
+    }
+    free(names);
+
+    return rv == WORKLIST_FAILURE ? WORKLIST_FAILURE : added;
+}
+
+/* Add one path: a directory is walked, anything else taken as is */
+static int add_path(worklist* w, const char* path){
+    struct stat st;
+
+    if(stat(path, &st) == 0 && S_ISDIR(st.st_mode)){
+	return add_dir(w, path);
+    }
+    return push_path(w, path);
+}
+
+int worklist_add(worklist* w, const char* arg){
+    glob_t g;
+    size_t i;
+    int added = 0;
+    int rv;
+
+    if(!strpbrk(arg, "*?[")){
+	return add_path(w, arg);
+    }
+
+    /* usually the shell expanded it already, this covers quoted
+     * patterns and matches too many for the argument list */
+    rv = glob(arg, 0, NULL, &g);
+    if(rv == GLOB_NOMATCH){
+	fprintf(stderr, "No input files match %s\n", arg);
+	return 0;
+    }
+    if(rv){
+	fprintf(stderr, "Error expanding %s\n", arg);
+	return WORKLIST_FAILURE;
+    }
+    for(i=0; i<g.gl_pathc; i++){
+	rv = add_path(w, g.gl_pathv[i]);
+	if(rv == WORKLIST_FAILURE){
+	    globfree(&g);
+	    return WORKLIST_FAILURE;
+	}
+	added += rv;
+    }
+    globfree(&g);
+
+    return added;
+}
+
+const char* worklist_next(worklist* w, const char** prefetch, size_t* index){
+    const char* path = NULL;
+
+    *prefetch = NULL;
+    pthread_mutex_lock(&w->lock);
+    if(w->next < w->count){
+	*index = w->next;
+	path = w->paths[w->next++];
+	/* the file after this one is what the next free producer
+	 * takes, start reading it now unless someone already did */
+	if(w->next < w->count && w->hinted <= w->next){
+	    *prefetch = w->paths[w->next];
+	    w->hinted = w->next + 1;
+	}
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    return path;
+}
+
+void worklist_prefetch(const char* path){
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0){
+	/* the producer that takes it reports the error */
+	return;
+    }
+    /* readahead is asynchronous, the pages keep coming after close */
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+}
+
+void worklist_cleanup(worklist* w){
+    size_t i;
+
+    for(i=0; i<w->count; i++){
+	free(w->paths[i]);
+    }
+    free(w->paths);
+    w->paths = NULL;
+    w->count = w->cap = 0;
+    pthread_mutex_destroy(&w->lock);
+}
@@ -0,0 +1,61 @@
+/*
+ * File: worklist.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the list of input files shared by
+ *      the multi-lookup producer pool. Arguments are expanded up front
+ *      (directories recursively, globs through glob(3)), then
+ *      producers take files off the list one at a time.
+ *
+ */
+
+#ifndef WORKLIST_H
+#define WORKLIST_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#define WORKLIST_FAILURE -1
+#define WORKLIST_SUCCESS 0
+
+typedef struct worklist_s{
+    char** paths;
+    size_t count;
+    size_t cap;
+    pthread_mutex_t lock;   /* guards next and hinted */
+    size_t next;            /* first file nobody has taken */
+    size_t hinted;          /* files below this were already prefetched */
+} worklist;
+
+/* Function to initialize an empty list
+ * Returns WORKLIST_SUCCESS or WORKLIST_FAILURE
+ */
+int worklist_init(worklist* w);
+
+/* Function to add one input argument
+ * A directory adds every file under it (symlinks to directories
+ * inside it are not followed), a pattern with *, ? or [
+ * adds its matches, anything else is added as is (a file that
+ * cannot be opened is reported by whoever reads it).
+ * Returns the number of files added or WORKLIST_FAILURE
+ */
+int worklist_add(worklist* w, const char* arg);
+
+/* Function to take the next file, safe from any thread
+ * *prefetch is set to the file after it when nobody has been told to
+ * prefetch that one yet, NULL otherwise. *index is the file's place
+ * in the list.
+ * Returns the path, or NULL once every file has been taken
+ */
+const char* worklist_next(worklist* w, const char** prefetch, size_t* index);
+
+/* Function to ask the kernel to start reading path into the page
+ * cache, without waiting for it and without keeping it open */
+void worklist_prefetch(const char* path);
+
+/* Function to free the list */
+void worklist_cleanup(worklist* w);
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * File: zone-bench.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Startup and lookup benchmark for the -z zone table. Writes a
+ *      hosts file of generated names to a temporary file, loads it the
+ *      way multi-lookup does, and reports parse and build time, table
+ *      size, and lookup rates for names in and not in the table.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "zone.h"
+
+#define USAGE "[names] [lookups]"
+#define TMPTEMPLATE "/tmp/zone-bench-XXXXXX"
+#define POOLSIZE (1 << 20)
+#define NAMESTRIDE 48
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* xorshift64, the same names every run */
+static uint64_t next_rand(uint64_t* state){
+    uint64_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/* Generated names: every fourth one also gets an IPv6 address */
+static int write_hosts(FILE* fp, long nnames){
+    long i;
+
+    for(i=0; i<nnames; i++){
+	if(fprintf(fp, "10.%ld.%ld.%ld host%ld.rack%ld.bench.internal\n",
+		   (i >> 16) & 255, (i >> 8) & 255, i & 255, i, i % 97) < 0){
+	    return -1;
+	}
+	if(i % 4 == 0 &&
+	   fprintf(fp, "fd00::%lx host%ld.rack%ld.bench.internal\n",
+		   i & 0xffff, i, i % 97) < 0){
+	    return -1;
+	}
+    }
+    return 0;
+}
+
+/* Names to look up, made before the clock starts and packed one
+ * after another so reading them is sequential. A pool is reused so
+ * the names themselves stay small next to the table. */
+static char* make_names(long nnames, long count, bool hits){
+    uint64_t state = hits ? 88172645463325252ULL : 2463534242ULL;
+    char* names = malloc(count * NAMESTRIDE);
+    long i;
+
+    if(!names){
+	return NULL;
+    }
+    for(i=0; i<count; i++){
+	long n = (long)(next_rand(&state) % nnames);
+	snprintf(names + i * NAMESTRIDE, NAMESTRIDE,
+		 "host%ld.rack%ld.bench.%s",
+		 n, n % 97, hits ? "internal" : "external");
+    }
+    return names;
+}
+
+static double run_lookups(const zone* z, const char* names, long count,
+			  long lookups, long* found){
+    ip_list_t ips;
+    double start;
+    long i;
+
+    *found = 0;
+    start = now();
+    for(i=0; i<lookups; i++){
+	if(zone_lookup(z, names + (i % count) * NAMESTRIDE, &ips)){
+	    *found += 1;
+	}
+    }
+    return now() - start;
+}
+
+int main(int argc, char* argv[]){
+
+    /* Local Vars */
+    char path[] = TMPTEMPLATE;
+    char* paths[1];
+    FILE* fp;
+    int fd;
+    zone z;
+    long nnames = 1000000;
+    long lookups = 5000000;
+    long found;
+    long pool;
+    char* hitNames;
+    char* missNames;
+    double start;
+    double loadTime;
+    double hitTime;
+    double missTime;
+
+    /* Check Arguments */
+    if(argc > 1){
+	nnames = atol(argv[1]);
+    }
+    if(argc > 2){
+	lookups = atol(argv[2]);
+    }
+    if(nnames < 1 || lookups < 1){
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	return EXIT_FAILURE;
+    }
+
+    /* Write the hosts file */
+    fd = mkstemp(path);
+    if(fd < 0){
+	perror("Error creating temporary file");
+	return EXIT_FAILURE;
+    }
+    fp = fdopen(fd, "w");
+    if(!fp || write_hosts(fp, nnames) || fclose(fp)){
+	perror("Error writing temporary file");
+	unlink(path);
+	return EXIT_FAILURE;
+    }
+
+    /* Load it */
+    paths[0] = path;
+    start = now();
+    if(zone_load(&z, paths, 1) == ZONE_FAILURE){
+	unlink(path);
+	return EXIT_FAILURE;
+    }
+    loadTime = now() - start;
+    unlink(path);
+
+    /* Look names up */
+    pool = lookups < POOLSIZE ? lookups : POOLSIZE;
+    hitNames = make_names(nnames, pool, true);
+    missNames = make_names(nnames, pool, false);
+    if(!hitNames || !missNames){
+	perror("Error on bench Malloc");
+	return EXIT_FAILURE;
+    }
+    /* one untimed pass first so page faults and clock ramp-up are
+     * not charged to whichever case runs first */
+    run_lookups(&z, missNames, pool, pool, &found);
+    hitTime = run_lookups(&z, hitNames, pool, lookups, &found);
+    if(found != lookups){
+	fprintf(stderr, "only %ld of %ld generated names found\n",
+		found, lookups);
+	zone_cleanup(&z);
+	return EXIT_FAILURE;
+    }
+    missTime = run_lookups(&z, missNames, pool, lookups, &found);
+    free(hitNames);
+    free(missNames);
+
+    /* Report */
+    fprintf(stdout, "names=%zu addresses=%zu slots=%u buckets=%u\n",
+	    z.nnames, z.naddrs, z.nslots, z.nbuckets);
+    fprintf(stdout, "load=%.3fs parse=%.3fs build=%.3fs table=%.1fMB (%.1f bytes/name)\n",
+	    loadTime, z.parseSeconds, z.buildSeconds,
+	    zone_memory(&z) / 1048576.0, (double)zone_memory(&z) / z.nnames);
+    fprintf(stdout, "hit  lookups=%ld rate=%.0f/s %.0fns each\n",
+	    lookups, lookups / hitTime, 1e9 * hitTime / lookups);
+    fprintf(stdout, "miss lookups=%ld rate=%.0f/s %.0fns each (%ld false hits)\n",
+	    lookups, lookups / missTime, 1e9 * missTime / lookups, found);
+
+    zone_cleanup(&z);
+
+    return found ? EXIT_FAILURE : EXIT_SUCCESS;
+}
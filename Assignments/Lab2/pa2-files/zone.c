@@ -0,0 +1,653 @@
+/*
+ * File: zone.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the static zone table for multi-lookup -z.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "zone.h"
+
+#define ZONE_MAX_SEEDS 32
+#define ZONE_MAX_BUCKET (ZONE_BUCKET_SIZE * 8)
+
+/* A name while loading, addresses chained through the node pool */
+typedef struct build_name_s{
+    uint64_t hash;
+    uint32_t keyOff;
+    uint16_t keyLen;
+    uint8_t naddrs;
+    uint32_t first;             /* node index + 1, 0 for none */
+    uint32_t last;
+} build_name;
+
+typedef struct build_node_s{
+    ip_addr_t addr;
+    uint32_t next;
+} build_node;
+
+typedef struct builder_s{
+    build_name* names;
+    size_t nnames;
+    size_t namesCap;
+    build_node* nodes;
+    size_t nnodes;
+    size_t nodesCap;
+    char* keys;
+    size_t keysLen;
+    size_t keysCap;
+    uint32_t* index;            /* open addressing, name index + 1 */
+    size_t indexCap;            /* power of two */
+} builder;
+
+static double seconds_since(const struct timespec* start){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Rehash under a seed, a new seed gives the builder fresh positions */
+static uint64_t mix(uint64_t h, uint64_t seed){
+    h ^= seed;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Which bucket, and the first slot and step of a name's probe
+ * sequence. The slot for displacement d is (f1 + d * f2) % nslots,
+ * with nslots prime every d up to nslots lands somewhere new. */
+static void place(const zone* z, uint64_t h, uint32_t* bucket,
+		  uint32_t* f1, uint32_t* f2){
+    uint64_t g = mix(h, z->seed);
+
+    *bucket = (uint32_t)(((g >> 32) * z->nbuckets) >> 32);
+    /* multiply and shift maps 32 bits onto a range without dividing */
+    *f1 = (uint32_t)(((g & 0xffffffffULL) * z->nslots) >> 32);
+    *f2 = 1 + (uint32_t)((((g >> 16) & 0xffffffffULL) * (z->nslots - 1)) >> 32);
+}
+
+static uint32_t slot_for(const zone* z, uint32_t f1, uint32_t f2, uint32_t d){
+    return (uint32_t)((f1 + (uint64_t)d * f2) % z->nslots);
+}
+
+static bool is_prime(uint32_t n){
+    uint32_t i;
+
+    if(n < 2){
+	return false;
+    }
+    for(i=2; (uint64_t)i*i <= n; i++){
+	if(n % i == 0){
+	    return false;
+	}
+    }
+    return true;
+}
+
+static bool grow(void** p, size_t* cap, size_t need, size_t size){
+    size_t ncap;
+    void* q;
+
+    if(need <= *cap){
+	return true;
+    }
+    ncap = *cap ? *cap : 1024;
+    while(ncap < need){
+	ncap *= 2;
+    }
+    q = realloc(*p, ncap * size);
+    if(!q){
+	perror("Error on zone Malloc");
+	return false;
+    }
+    *p = q;
+    *cap = ncap;
+    return true;
+}
+
+static bool index_grow(builder* b){
+    size_t cap = b->indexCap ? b->indexCap * 2 : 1024;
+    uint32_t* index = calloc(cap, sizeof(*index));
+    size_t i;
+
+    if(!index){
+	perror("Error on zone Malloc");
+	return false;
+    }
+    for(i=0; i<b->nnames; i++){
+	size_t pos = b->names[i].hash & (cap - 1);
+	while(index[pos]){
+	    pos = (pos + 1) & (cap - 1);
+	}
+	index[pos] = i + 1;
+    }
+    free(b->index);
+    b->index = index;
+    b->indexCap = cap;
+    return true;
+}
+
+/* Add one address for one name, repeats of either are merged */
+static bool builder_add(builder* b, const char* name, const ip_addr_t* addr){
+    char key[ZONE_MAX_NAME];
+    size_t len = name_normalize(name, key, sizeof(key));
+    uint64_t h;
+    size_t pos;
+    build_name* n = NULL;
+    uint32_t i;
+
+    if(len == 0 || strchr(key, '*')){
+	return true;
+    }
+    h = name_hash(key, len);
+
+    if((b->nnames + 1) * 2 > b->indexCap && !index_grow(b)){
+	return false;
+    }
+    for(pos=h & (b->indexCap - 1); b->index[pos];
+	pos=(pos + 1) & (b->indexCap - 1)){
+	build_name* e = &b->names[b->index[pos] - 1];
+	if(e->hash == h && e->keyLen == len &&
+	   !memcmp(b->keys + e->keyOff, key, len)){
+	    n = e;
+	    break;
+	}
+    }
+
+    if(!n){
+	if(b->keysLen + len > UINT32_MAX){
+	    fprintf(stderr, "zone: too many names\n");
+	    return false;
+	}
+	if(!grow((void**)&b->names, &b->namesCap, b->nnames + 1,
+		 sizeof(*b->names)) ||
+	   !grow((void**)&b->keys, &b->keysCap, b->keysLen + len, 1)){
+	    return false;
+	}
+	n = &b->names[b->nnames];
+	n->hash = h;
+	n->keyOff = b->keysLen;
+	n->keyLen = len;
+	n->naddrs = 0;
+	n->first = n->last = 0;
+	memcpy(b->keys + b->keysLen, key, len);
+	b->keysLen += len;
+	b->index[pos] = ++b->nnames;
+    }
+
+    if(n->naddrs == UTIL_MAX_ADDRS){
+	return true;
+    }
+    for(i=n->first; i; i=b->nodes[i-1].next){
+	if(b->nodes[i-1].addr.family == addr->family &&
+	   !memcmp(b->nodes[i-1].addr.addr, addr->addr, sizeof(addr->addr))){
+	    return true;
+	}
+    }
+    if(!grow((void**)&b->nodes, &b->nodesCap, b->nnodes + 1,
+	     sizeof(*b->nodes))){
+	return false;
+    }
+    b->nodes[b->nnodes].addr = *addr;
+    b->nodes[b->nnodes].next = 0;
+    b->nnodes++;
+    if(n->last){
+	b->nodes[n->last - 1].next = b->nnodes;
+    }
+    else{
+	n->first = b->nnodes;
+    }
+    n->last = b->nnodes;
+    n->naddrs++;
+    return true;
+}
+
+static bool parse_addr(const char* text, int family, ip_addr_t* addr){
+    memset(addr, 0, sizeof(*addr));
+    if((family == AF_UNSPEC || family == AF_INET) &&
+       inet_pton(AF_INET, text, addr->addr) == 1){
+	addr->family = AF_INET;
+	return true;
+    }
+    if((family == AF_UNSPEC || family == AF_INET6) &&
+       inet_pton(AF_INET6, text, addr->addr) == 1){
+	addr->family = AF_INET6;
+	return true;
+    }
+    return false;
+}
+
+static bool is_class(const char* tok){
+    return !strcasecmp(tok, "IN") || !strcasecmp(tok, "CH") ||
+	!strcasecmp(tok, "HS") || !strcasecmp(tok, "CS");
+}
+
+/* Make a zone owner name absolute */
+static void qualify(const char* owner, const char* origin, char* out,
+		    size_t outSize){
+    size_t len = strlen(owner);
+
+    if(!strcmp(owner, "@")){
+	snprintf(out, outSize, "%s", origin);
+    }
+    else if(len && owner[len-1] != '.' && origin[0]){
+	snprintf(out, outSize, "%s.%s", owner, origin);
+    }
+    else{
+	snprintf(out, outSize, "%s", owner);
+    }
+}
+
+static int load_file(builder* b, const char* path){
+    FILE* fp;
+    char* line = NULL;
+    size_t lineCap = 0;
+    char origin[ZONE_MAX_NAME] = "";
+    char owner[ZONE_MAX_NAME] = "";
+    char name[ZONE_MAX_NAME];
+    bool inParen = false;
+    int rv = ZONE_SUCCESS;
+
+    fp = fopen(path, "r");
+    if(!fp){
+	perror(path);
+	return ZONE_FAILURE;
+    }
+
+    while(getline(&line, &lineCap, fp) != -1){
+	char* tok[8];
+	int ntok = 0;
+	bool continued = (line[0] == ' ' || line[0] == '\t');
+	char* save;
+	char* p;
+	ip_addr_t addr;
+	int i;
+
+	line[strcspn(line, "#;\r\n")] = '\0';
+
+	/* multi-line records (SOA and the like) are never A or AAAA */
+	if(inParen){
+	    if(strchr(line, ')')){
+		inParen = false;
+	    }
+	    continue;
+	}
+	if(strchr(line, '(') && !strchr(line, ')')){
+	    inParen = true;
+	}
+
+	for(p=strtok_r(line, " \t", &save); p && ntok < 8;
+	    p=strtok_r(NULL, " \t", &save)){
+	    tok[ntok++] = p;
+	}
+	if(ntok == 0){
+	    continue;
+	}
+
+	/* hosts file line */
+	if(!continued && parse_addr(tok[0], AF_UNSPEC, &addr)){
+	    for(i=1; i<ntok; i++){
+		if(!builder_add(b, tok[i], &addr)){
+		    rv = ZONE_FAILURE;
+		    break;
+		}
+	    }
+	    if(rv == ZONE_FAILURE){
+		break;
+	    }
+	    continue;
+	}
+
+	/* zone file directive or record */
+	if(tok[0][0] == '$'){
+	    if(!strcasecmp(tok[0], "$ORIGIN") && ntok > 1){
+		qualify(tok[1], origin, name, sizeof(name));
+		snprintf(origin, sizeof(origin), "%s", name);
+	    }
+	    continue;
+	}
+	i = 0;
+	if(!continued){
+	    qualify(tok[0], origin, owner, sizeof(owner));
+	    i = 1;
+	}
+	while(i < ntok && (isdigit((unsigned char)tok[i][0]) ||
+			   is_class(tok[i]))){
+	    i++;
+	}
+	if(i + 1 >= ntok || !owner[0]){
+	    continue;
+	}
+	if(!strcasecmp(tok[i], "A")){
+	    if(!parse_addr(tok[i+1], AF_INET, &addr)){
+		continue;
+	    }
+	}
+	else if(!strcasecmp(tok[i], "AAAA")){
+	    if(!parse_addr(tok[i+1], AF_INET6, &addr)){
+		continue;
+	    }
+	}
+	else{
+	    continue;
+	}
+	if(!builder_add(b, owner, &addr)){
+	    rv = ZONE_FAILURE;
+	    break;
+	}
+    }
+
+    if(rv == ZONE_SUCCESS && ferror(fp)){
+	perror(path);
+	rv = ZONE_FAILURE;
+    }
+    free(line);
+    fclose(fp);
+    return rv;
+}
+
+/* One attempt at a displacement for every bucket under z->seed.
+ * Buckets are placed biggest first while the table is still empty.
+ * Returns false if some bucket found no free slots, the caller then
+ * tries another seed. */
+static bool build_try(zone* z, const builder* b, uint32_t* start,
+		      uint32_t* members, uint32_t* order, uint32_t* f1,
+		      uint32_t* f2, uint64_t* taken, uint32_t* owner){
+    uint32_t* count = start;
+    uint32_t bysize[ZONE_MAX_BUCKET + 1];
+    uint32_t maxSize = 0;
+    uint32_t used;
+    uint32_t i;
+    uint32_t k;
+    uint32_t o;
+    int s;
+
+    memset(start, 0, (z->nbuckets + 1) * sizeof(*start));
+
+    /* group names by bucket */
+    for(i=0; i<b->nnames; i++){
+	uint32_t bk;
+	place(z, b->names[i].hash, &bk, &f1[i], &f2[i]);
+	members[i] = bk;
+	count[bk + 1]++;
+    }
+    for(i=0; i<z->nbuckets; i++){
+	if(count[i + 1] > maxSize){
+	    maxSize = count[i + 1];
+	}
+	start[i + 1] += start[i];
+    }
+    /* an overfull bucket means a poor seed, not worth placing */
+    if(maxSize > ZONE_MAX_BUCKET){
+	return false;
+    }
+    {
+	uint32_t* fill = order;
+	uint32_t* sorted = owner;
+	/* owner doubles as scratch here, it is cleared again below */
+	for(i=0; i<z->nbuckets; i++){
+	    fill[i] = start[i];
+	}
+	for(i=0; i<b->nnames; i++){
+	    sorted[fill[members[i]]++] = i;
+	}
+	memcpy(members, sorted, b->nnames * sizeof(*members));
+	for(i=0; i<z->nslots; i++){
+	    owner[i] = 0;
+	}
+    }
+    memset(taken, 0, ((z->nslots + 63) / 64) * sizeof(*taken));
+
+    /* buckets by size, biggest first, skipping empty ones */
+    memset(bysize, 0, sizeof(bysize));
+    for(i=0; i<z->nbuckets; i++){
+	bysize[start[i + 1] - start[i]]++;
+    }
+    for(s=maxSize, used=0; s>0; s--){
+	uint32_t n = bysize[s];
+	bysize[s] = used;
+	used += n;
+    }
+    for(i=0; i<z->nbuckets; i++){
+	uint32_t n = start[i + 1] - start[i];
+	if(n){
+	    order[bysize[n]++] = i;
+	}
+    }
+
+    for(o=0; o<used; o++){
+	uint32_t bk = order[o];
+	uint32_t first = start[bk];
+	uint32_t n = start[bk + 1] - first;
+	uint32_t pos[ZONE_MAX_BUCKET];
+	uint32_t d;
+	bool placed = false;
+
+	for(k=0; k<n; k++){
+	    pos[k] = f1[members[first + k]];
+	}
+	/* step every name's slot along by its f2 until they all land
+	 * on free slots. The bitmap is small enough to stay in cache,
+	 * owner is only written once a displacement works. */
+	for(d=0; d<z->nslots; d++){
+	    placed = true;
+	    for(k=0; k<n; k++){
+		if(taken[pos[k] >> 6] & (1ULL << (pos[k] & 63))){
+		    placed = false;
+		    break;
+		}
+		taken[pos[k] >> 6] |= 1ULL << (pos[k] & 63);
+	    }
+	    if(placed){
+		break;
+	    }
+	    /* take back what this displacement claimed */
+	    while(k-- > 0){
+		taken[pos[k] >> 6] &= ~(1ULL << (pos[k] & 63));
+	    }
+	    for(k=0; k<n; k++){
+		pos[k] += f2[members[first + k]];
+		if(pos[k] >= z->nslots){
+		    pos[k] -= z->nslots;
+		}
+	    }
+	}
+	if(!placed){
+	    return false;
+	}
+	for(k=0; k<n; k++){
+	    owner[pos[k]] = members[first + k] + 1;
+	}
+	z->disp[bk] = d;
+    }
+    return true;
+}
+
+/* Lay the names out in their slots */
+static int build_table(zone* z, builder* b){
+    uint32_t* start = NULL;
+    uint32_t* members = NULL;
+    uint32_t* order = NULL;
+    uint32_t* f1 = NULL;
+    uint32_t* f2 = NULL;
+    uint32_t* owner = NULL;
+    uint64_t* taken = NULL;
+    uint64_t m;
+    size_t dataLen;
+    uint32_t off = 0;
+    uint32_t i;
+    int tries;
+    int rv = ZONE_FAILURE;
+
+    if(b->nnames >= UINT32_MAX / 2){
+	fprintf(stderr, "zone: too many names\n");
+	return ZONE_FAILURE;
+    }
+    m = (uint64_t)(b->nnames / ZONE_LOAD) + 1;
+    if(m < 3){
+	m = 3;
+    }
+    while(!is_prime(m)){
+	m++;
+    }
+    z->nslots = m;
+    z->nbuckets = (b->nnames + ZONE_BUCKET_SIZE - 1) / ZONE_BUCKET_SIZE;
+    if(z->nbuckets == 0){
+	z->nbuckets = 1;
+    }
+
+    z->disp = calloc(z->nbuckets, sizeof(*z->disp));
+    z->slots = calloc(z->nslots, sizeof(*z->slots));
+    dataLen = b->keysLen + b->nnodes * sizeof(ip_addr_t);
+    if(dataLen > UINT32_MAX){
+	fprintf(stderr, "zone: too many names\n");
+	return ZONE_FAILURE;
+    }
+    z->data = malloc(dataLen ? dataLen : 1);
+    start = malloc((z->nbuckets + 1) * sizeof(*start));
+    members = malloc((b->nnames + 1) * sizeof(*members));
+    order = malloc(((b->nnames > z->nbuckets ? b->nnames : z->nbuckets) + 1)
+		   * sizeof(*order));
+    f1 = malloc((b->nnames + 1) * sizeof(*f1));
+    f2 = malloc((b->nnames + 1) * sizeof(*f2));
+    owner = malloc(z->nslots * sizeof(*owner));
+    taken = malloc(((z->nslots + 63) / 64) * sizeof(*taken));
+    if(!z->disp || !z->slots || !z->data || !start || !members || !order ||
+       !f1 || !f2 || !owner || !taken){
+	perror("Error on zone Malloc");
+	goto out;
+    }
+
+    z->seed = 0x9e3779b97f4a7c15ULL;
+    for(tries=0; tries<ZONE_MAX_SEEDS; tries++){
+	if(build_try(z, b, start, members, order, f1, f2, taken, owner)){
+	    break;
+	}
+	z->seed = mix(z->seed, tries + 1);
+    }
+    if(tries == ZONE_MAX_SEEDS){
+	fprintf(stderr, "zone: could not build the table\n");
+	goto out;
+    }
+
+    /* records in slot order, addresses first and then the key, so a
+     * hit touches the slot and one more cache line or two */
+    for(i=0; i<z->nslots; i++){
+	zone_slot* s = &z->slots[i];
+	build_name* n;
+	uint32_t node;
+
+	if(!owner[i]){
+	    continue;
+	}
+	n = &b->names[owner[i] - 1];
+	s->fp = (uint32_t)(n->hash >> 32);
+	s->off = off;
+	s->keyLen = n->keyLen;
+	s->naddrs = n->naddrs;
+	for(node=n->first; node; node=b->nodes[node-1].next){
+	    memcpy(z->data + off, &b->nodes[node-1].addr, sizeof(ip_addr_t));
+	    off += sizeof(ip_addr_t);
+	}
+	memcpy(z->data + off, b->keys + n->keyOff, n->keyLen);
+	off += n->keyLen;
+    }
+
+    z->dataLen = off;
+    z->nnames = b->nnames;
+    z->naddrs = b->nnodes;
+    rv = ZONE_SUCCESS;
+
+out:
+    free(start);
+    free(members);
+    free(order);
+    free(f1);
+    free(f2);
+    free(owner);
+    free(taken);
+    return rv;
+}
+
+int zone_load(zone* z, char* const* paths, int npaths){
+    builder b;
+    struct timespec t0;
+    int rv = ZONE_SUCCESS;
+    int i;
+
+    memset(z, 0, sizeof(*z));
+    memset(&b, 0, sizeof(b));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(i=0; i<npaths && rv == ZONE_SUCCESS; i++){
+	rv = load_file(&b, paths[i]);
+    }
+    free(b.index);
+    b.index = NULL;
+    z->parseSeconds = seconds_since(&t0);
+
+    if(rv == ZONE_SUCCESS){
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	rv = build_table(z, &b);
+	z->buildSeconds = seconds_since(&t0);
+    }
+
+    free(b.names);
+    free(b.nodes);
+    free(b.keys);
+    if(rv != ZONE_SUCCESS){
+	zone_cleanup(z);
+    }
+    return rv;
+}
+
+bool zone_lookup(const zone* z, const char* hostname, ip_list_t* ips){
+    char key[ZONE_MAX_NAME];
+    size_t len;
+    uint64_t h;
+    uint32_t bk;
+    uint32_t f1;
+    uint32_t f2;
+    const zone_slot* s;
+
+    if(!z->nnames){
+	return false;
+    }
+    len = name_normalize(hostname, key, sizeof(key));
+    h = name_hash(key, len);
+    place(z, h, &bk, &f1, &f2);
+    s = &z->slots[slot_for(z, f1, f2, z->disp[bk])];
+
+    /* a name not in the table still lands on some slot */
+    if(s->fp != (uint32_t)(h >> 32) || s->keyLen != len ||
+       memcmp(z->data + s->off + s->naddrs * sizeof(ip_addr_t), key, len)){
+	return false;
+    }
+    ips->naddrs = s->naddrs;
+    memcpy(ips->addrs, z->data + s->off, s->naddrs * sizeof(ip_addr_t));
+    return true;
+}
+
+size_t zone_memory(const zone* z){
+    return z->nbuckets * sizeof(*z->disp) + z->nslots * sizeof(*z->slots) +
+	z->dataLen;
+}
+
+void zone_cleanup(zone* z){
+    free(z->disp);
+    free(z->slots);
+    free(z->data);
+    memset(z, 0, sizeof(*z));
+}
@@ -0,0 +1,81 @@
+/*
+ * File: zone.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 2
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the static zone table behind
+ *      multi-lookup -z. Hosts files and zone dumps are loaded once at
+ *      startup into an immutable table indexed by a minimal-ish
+ *      perfect hash (hash and displace, as in CHD): every name has
+ *      exactly one slot it can be in, so a lookup is one hash, one
+ *      displacement read and one slot compare, with no locks.
+ *
+ *      Accepted input, one record per line:
+ *        hosts style   address name [alias ...]     # comment
+ *        zone style    name [ttl] [class] A|AAAA address ; comment
+ *      Zone files may use $ORIGIN, @ and relative names, and lines
+ *      starting with blanks belong to the previous name. Other
+ *      record types are ignored.
+ *
+ */
+
+#ifndef ZONE_H
+#define ZONE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "util.h"
+
+#define ZONE_FAILURE -1
+#define ZONE_SUCCESS 0
+
+#define ZONE_MAX_NAME 1025
+#define ZONE_BUCKET_SIZE 4      /* average names per displacement bucket */
+#define ZONE_LOAD 0.9           /* names per slot */
+
+/* 12 bytes. The record at data + off is naddrs addresses followed
+ * by the normalized name, keyLen bytes, so the answer sits right
+ * next to the key it is checked against. */
+typedef struct zone_slot_s{
+    uint32_t fp;                /* high half of the name hash */
+    uint32_t off;               /* into data */
+    uint16_t keyLen;            /* 0 for an empty slot */
+    uint8_t naddrs;
+    uint8_t pad;
+} zone_slot;
+
+typedef struct zone_s{
+    uint64_t seed;
+    uint32_t nbuckets;
+    uint32_t nslots;            /* prime, so every displacement step works */
+    uint32_t* disp;             /* per bucket */
+    zone_slot* slots;
+    char* data;                 /* records, see zone_slot */
+    size_t dataLen;
+    size_t nnames;
+    size_t naddrs;
+    double parseSeconds;        /* startup cost, for -z and zone-bench */
+    double buildSeconds;
+} zone;
+
+/* Function to load and index every file in paths
+ * Returns ZONE_SUCCESS or ZONE_FAILURE
+ */
+int zone_load(zone* z, char* const* paths, int npaths);
+
+/* Function to look hostname up, case and trailing dot insensitive,
+ * safe from any number of threads at once
+ * Returns true and fills ips if the name is in the table
+ */
+bool zone_lookup(const zone* z, const char* hostname, ip_list_t* ips);
+
+/* Function to report the bytes the table takes */
+size_t zone_memory(const zone* z);
+
+/* Function to free the table */
+void zone_cleanup(zone* z);
+
+#endif
@@ -0,0 +1,536 @@
+/*
+ * File: bench.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Benchmark driver for the scheduling workloads, in place of
+ *      running /usr/bin/time in a loop. The matrix is every workload
+ *      x policy x process count, each run reps times. Repetitions are
+ *      interleaved (one pass over the whole matrix per repetition) so
+ *      a slow drift on the host spreads over every cell. Each run is
+ *      forked and exec'd here with all children started together
+ *      (-c), and reaped with wait4 for its rusage, which covers the
+ *      workload and every child it waited for. The per-child timing
+ *      the workload prints on its "launch:" line (see launch.h) is
+ *      read back from its output. Results go out as CSV or JSON with
+ *      mean, standard deviation and a 95% confidence interval per
+ *      cell and metric.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "stats.h"
+
+#define USAGE "[-w workload,...] [-p policy,...] [-n processes,...] [-r reps]\n" \
+    "        [-i iterations] [-b bytes] [-k blocksize] [-f csv|json] [-o outputFile] [-j jsonFile] [-q]"
+#define MAXLIST 16
+#define MAXPOLICIES 128             /* after sweeps are expanded */
+#define MAXARGS 16
+#define ARGLEN 32
+
+/* The defaults are the runscript matrix */
+#define DEFAULT_WORKLOADS "pi-sched,rw,mixed"
+#define DEFAULT_POLICIES "SCHED_OTHER,SCHED_FIFO,SCHED_RR"
+#define DEFAULT_PROCESSES "7,70,300"
+#define DEFAULT_REPS 10
+#define DEFAULT_ITERATIONS 100000
+#define DEFAULT_BYTES 102400
+#define DEFAULT_BLOCKSIZE 1024
+
+/* how a workload takes its arguments */
+#define KIND_CPU 0              /* prog -c ITERATIONS POLICY PROCESSES */
+#define KIND_IO 1               /* prog -c PROCESSES POLICY BYTES BLOCKSIZE */
+
+typedef struct workload_s{
+    const char* name;
+    const char* path;
+    int kind;
+} workload;
+
+static const workload workloads[] = {
+    { "pi-sched", "./pi-sched", KIND_CPU },
+    { "mixed", "./mixed", KIND_CPU },
+    { "rw", "./rw", KIND_IO },
+};
+
+/* what is kept of each run */
+#define M_WALL 0
+#define M_USER 1
+#define M_SYS 2
+#define M_VCSW 3
+#define M_IVCSW 4
+#define M_MAXRSS 5
+#define M_MAKESPAN 6
+#define M_TURN_P50 7
+#define M_TURN_P99 8
+#define M_FIRST_MAX 9
+#define M_JAIN 10
+#define NMETRICS 11
+
+static const char* metricNames[NMETRICS] = {
+    "wall_s", "user_s", "sys_s", "voluntary_switches",
+    "involuntary_switches", "max_rss_kb", "makespan_s",
+    "turnaround_p50_s", "turnaround_p99_s", "first_run_max_s", "jain"
+};
+
+typedef struct cell_s{
+    const workload* w;
+    const char* policy;
+    int procs;
+    int ok;                     /* runs that exited 0 */
+    int failed;
+    double* values[NMETRICS];   /* reps slots each, ok used */
+} cell;
+
+typedef struct matrix_s{
+    char* workloads[MAXLIST];
+    int nworkloads;
+    char* policies[MAXPOLICIES];
+    int npolicies;
+    int procs[MAXLIST];
+    int nprocs;
+    int reps;
+    long iterations;
+    long bytes;
+    long blocksize;
+} matrix;
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double tv_seconds(const struct timeval* tv){
+    return tv->tv_sec + tv->tv_usec / 1e6;
+}
+
+/* Split a comma list in place
+ * Returns the number of items, or -1 if there are too many
+ */
+static int split(char* list, char** items){
+    char* save;
+    char* p;
+    int n = 0;
+
+    for(p=strtok_r(list, ",", &save); p; p=strtok_r(NULL, ",", &save)){
+	if(n == MAXLIST){
+	    return -1;
+	}
+	items[n++] = p;
+    }
+    return n;
+}
+
+/* Expand the sweep in each policy, a "from..to[/step]" in place of a
+ * nice value or priority, into one policy per value:
+ * SCHED_OTHER:0..15/5 is SCHED_OTHER:0, :5, :10 and :15
+ * Returns the number of policies, or -1 on a bad sweep or too many
+ */
+static int expand_sweeps(char** items, int n, char** policies){
+    char* dots;
+    char* from;
+    char* end;
+    char* p;
+    long first, last, step, v;
+    int count = 0;
+    int len;
+    int i;
+
+    for(i=0; i<n; i++){
+	if(!(dots = strstr(items[i], ".."))){
+	    if(count == MAXPOLICIES){
+		return -1;
+	    }
+	    policies[count++] = items[i];
+	    continue;
+	}
+	for(from=dots; from>items[i] && (isdigit((unsigned char)from[-1]) || from[-1] == '-'); from--);
+	first = strtol(from, &end, 10);
+	if(end != dots){
+	    fprintf(stderr, "Bad sweep in %s\n", items[i]);
+	    return -1;
+	}
+	last = strtol(dots + 2, &end, 10);
+	step = 1;
+	if(*end == '/'){
+	    step = strtol(end + 1, &end, 10);
+	}
+	if(end == dots + 2 || step < 1 || last < first){
+	    fprintf(stderr, "Bad sweep in %s\n", items[i]);
+	    return -1;
+	}
+	for(v=first; v<=last; v+=step){
+	    len = snprintf(NULL, 0, "%.*s%ld%s", (int)(from - items[i]), items[i], v, end);
+	    if(count == MAXPOLICIES || !(p = malloc(len + 1))){
+		return -1;
+	    }
+	    sprintf(p, "%.*s%ld%s", (int)(from - items[i]), items[i], v, end);
+	    policies[count++] = p;
+	}
+    }
+    return count;
+}
+
+static const workload* find_workload(const char* name){
+    size_t i;
+
+    for(i=0; i<sizeof(workloads)/sizeof(workloads[0]); i++){
+	if(!strcmp(workloads[i].name, name)){
+	    return &workloads[i];
+	}
+    }
+    return NULL;
+}
+
+/* Read the workload's output to the end, keeping its launch line
+ * Returns 0 if there was one
+ */
+static int read_launch(FILE* in, double* launchValues){
+    char* line = NULL;
+    size_t size = 0;
+    double p90, max, firstP50;
+    int children;
+    int found = -1;
+
+    while(getline(&line, &size, in) != -1){
+	if(sscanf(line, "launch: children=%d makespan=%lf turnaround_p50=%lf "
+		  "turnaround_p90=%lf turnaround_p99=%lf turnaround_max=%lf "
+		  "first_run_p50=%lf first_run_max=%lf jain=%lf",
+		  &children, &launchValues[M_MAKESPAN], &launchValues[M_TURN_P50],
+		  &p90, &launchValues[M_TURN_P99], &max, &firstP50,
+		  &launchValues[M_FIRST_MAX], &launchValues[M_JAIN]) == 9){
+	    found = 0;
+	}
+    }
+    free(line);
+    return found;
+}
+
+/* Run one cell once, reading its launch line from its output
+ * Returns 0 if the workload exited 0 and reported its timing
+ */
+static int run_once(const matrix* m, cell* c){
+    char args[MAXARGS][ARGLEN];
+    char* argv[MAXARGS];
+    double launchValues[NMETRICS];
+    struct rusage ru;
+    FILE* in;
+    double start;
+    double wall;
+    int status;
+    int argc = 0;
+    int pipefd[2];
+    int reported;
+    int metric;
+    pid_t pid;
+
+    argv[argc++] = (char*)c->w->path;
+    argv[argc++] = "-c";
+    if(c->w->kind == KIND_CPU){
+	snprintf(args[0], ARGLEN, "%ld", m->iterations);
+	snprintf(args[1], ARGLEN, "%d", c->procs);
+	argv[argc++] = args[0];
+	argv[argc++] = (char*)c->policy;
+	argv[argc++] = args[1];
+    }
+    else{
+	snprintf(args[0], ARGLEN, "%d", c->procs);
+	snprintf(args[1], ARGLEN, "%ld", m->bytes);
+	snprintf(args[2], ARGLEN, "%ld", m->blocksize);
+	argv[argc++] = args[0];
+	argv[argc++] = (char*)c->policy;
+	argv[argc++] = args[1];
+	argv[argc++] = args[2];
+    }
+    argv[argc] = NULL;
+
+    if(pipe(pipefd)){
+	perror("Error creating output pipe");
+	return -1;
+    }
+    fflush(NULL);
+    start = now();
+    pid = fork();
+    if(pid < 0){
+	perror("Error creating workload process");
+	close(pipefd[0]);
+	close(pipefd[1]);
+	return -1;
+    }
+    if(pid == 0){
+	close(pipefd[0]);
+	dup2(pipefd[1], STDOUT_FILENO);
+	close(pipefd[1]);
+	execv(argv[0], argv);
+	perror("Error starting workload");
+	_exit(127);
+    }
+    close(pipefd[1]);
+    if(!(in = fdopen(pipefd[0], "r"))){
+	perror("Error reading workload output");
+	close(pipefd[0]);
+	reported = -1;
+    }
+    else{
+	reported = read_launch(in, launchValues);
+	fclose(in);
+    }
+    if(wait4(pid, &status, 0, &ru) != pid){
+	perror("Error waiting for workload");
+	return -1;
+    }
+    wall = now() - start;
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0 || reported){
+	c->failed++;
+	return -1;
+    }
+
+    c->values[M_WALL][c->ok] = wall;
+    c->values[M_USER][c->ok] = tv_seconds(&ru.ru_utime);
+    c->values[M_SYS][c->ok] = tv_seconds(&ru.ru_stime);
+    c->values[M_VCSW][c->ok] = ru.ru_nvcsw;
+    c->values[M_IVCSW][c->ok] = ru.ru_nivcsw;
+    c->values[M_MAXRSS][c->ok] = ru.ru_maxrss;
+    for(metric=M_MAKESPAN; metric<NMETRICS; metric++){
+	c->values[metric][c->ok] = launchValues[metric];
+    }
+    c->ok++;
+    return 0;
+}
+
+static void write_csv(FILE* out, cell* cells, int ncells){
+    stats s;
+    int i;
+    int k;
+
+    fprintf(out, "workload,policy,processes,runs,failed,metric,mean,stddev,ci95,min,max\n");
+    for(i=0; i<ncells; i++){
+	for(k=0; k<NMETRICS; k++){
+	    stats_compute(cells[i].values[k], cells[i].ok, &s);
+	    fprintf(out, "%s,%s,%d,%d,%d,%s,%.6g,%.6g,%.6g,%.6g,%.6g\n",
+		    cells[i].w->name, cells[i].policy, cells[i].procs,
+		    cells[i].ok, cells[i].failed, metricNames[k],
+		    s.mean, s.stddev, s.ci95, s.min, s.max);
+	}
+    }
+}
+
+static void write_json(FILE* out, const matrix* m, cell* cells, int ncells){
+    stats s;
+    int i;
+    int j;
+    int k;
+
+    fprintf(out, "{\n  \"reps\": %d, \"iterations\": %ld, \"bytes\": %ld, \"blocksize\": %ld,\n",
+	    m->reps, m->iterations, m->bytes, m->blocksize);
+    fprintf(out, "  \"cells\": [\n");
+    for(i=0; i<ncells; i++){
+	fprintf(out, "    {\"workload\": \"%s\", \"policy\": \"%s\", \"processes\": %d, "
+		"\"runs\": %d, \"failed\": %d,\n     \"metrics\": {",
+		cells[i].w->name, cells[i].policy, cells[i].procs,
+		cells[i].ok, cells[i].failed);
+	for(k=0; k<NMETRICS; k++){
+	    stats_compute(cells[i].values[k], cells[i].ok, &s);
+	    fprintf(out, "%s\n       \"%s\": {\"mean\": %.6g, \"stddev\": %.6g, \"ci95\": %.6g, "
+		    "\"min\": %.6g, \"max\": %.6g, \"values\": [",
+		    k ? "," : "", metricNames[k], s.mean, s.stddev, s.ci95, s.min, s.max);
+	    for(j=0; j<cells[i].ok; j++){
+		fprintf(out, "%s%.6g", j ? ", " : "", cells[i].values[k][j]);
+	    }
+	    fprintf(out, "]}");
+	}
+	fprintf(out, "}}%s\n", i + 1 < ncells ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[]){
+
+    char workloadList[] = DEFAULT_WORKLOADS;
+    char policyList[] = DEFAULT_POLICIES;
+    char procsList[] = DEFAULT_PROCESSES;
+    char* procItems[MAXLIST];
+    char* policyItems[MAXLIST];
+    char* outputFilename = NULL;
+    char* jsonFilename = NULL;
+    int json = 0;
+    int quiet = 0;
+    matrix m;
+    cell* cells;
+    int ncells;
+    int opt;
+    int i, j, k;
+    int rep;
+    int done = 0;
+    FILE* out = stdout;
+    FILE* jsonOut = NULL;
+
+    m.reps = DEFAULT_REPS;
+    m.iterations = DEFAULT_ITERATIONS;
+    m.bytes = DEFAULT_BYTES;
+    m.blocksize = DEFAULT_BLOCKSIZE;
+    m.nworkloads = split(workloadList, m.workloads);
+    m.npolicies = split(policyList, policyItems);
+    m.nprocs = split(procsList, procItems);
+
+    while((opt = getopt(argc, argv, "b:f:i:j:k:n:o:p:qr:w:")) != -1){
+	switch(opt){
+	case 'b':
+	    m.bytes = atol(optarg);
+	    break;
+	case 'f':
+	    if(!strcmp(optarg, "json")){
+		json = 1;
+	    }
+	    else if(strcmp(optarg, "csv")){
+		fprintf(stderr, "Unknown output format %s\n", optarg);
+		exit(EXIT_FAILURE);
+	    }
+	    break;
+	case 'i':
+	    m.iterations = atol(optarg);
+	    break;
+	case 'j':
+	    /* JSON as well, to a second file */
+	    jsonFilename = optarg;
+	    break;
+	case 'k':
+	    m.blocksize = atol(optarg);
+	    break;
+	case 'n':
+	    m.nprocs = split(optarg, procItems);
+	    break;
+	case 'o':
+	    outputFilename = optarg;
+	    break;
+	case 'p':
+	    m.npolicies = split(optarg, policyItems);
+	    break;
+	case 'q':
+	    quiet = 1;
+	    break;
+	case 'r':
+	    m.reps = atoi(optarg);
+	    break;
+	case 'w':
+	    m.nworkloads = split(optarg, m.workloads);
+	    break;
+	default:
+	    fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	    exit(EXIT_FAILURE);
+	}
+    }
+    if(m.npolicies > 0){
+	m.npolicies = expand_sweeps(policyItems, m.npolicies, m.policies);
+    }
+    if(m.nworkloads < 1 || m.npolicies < 1 || m.nprocs < 1 || m.reps < 1 ||
+       m.iterations < 1 || m.bytes < 1 || m.blocksize < 1){
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	exit(EXIT_FAILURE);
+    }
+    for(i=0; i<m.nprocs; i++){
+	m.procs[i] = atoi(procItems[i]);
+	if(m.procs[i] < 1 || m.procs[i] > 1000){
+	    fprintf(stderr, "Bad process count %s\n", procItems[i]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    /* Lay out the matrix */
+    ncells = m.nworkloads * m.npolicies * m.nprocs;
+    if(!(cells = calloc(ncells, sizeof(*cells)))){
+	perror("Failed to allocate cells");
+	exit(EXIT_FAILURE);
+    }
+    ncells = 0;
+    for(i=0; i<m.nworkloads; i++){
+	const workload* w = find_workload(m.workloads[i]);
+	if(!w){
+	    fprintf(stderr, "Unknown workload %s\n", m.workloads[i]);
+	    exit(EXIT_FAILURE);
+	}
+	for(j=0; j<m.npolicies; j++){
+	    for(k=0; k<m.nprocs; k++){
+		cell* c = &cells[ncells++];
+		int metric;
+		c->w = w;
+		c->policy = m.policies[j];
+		c->procs = m.procs[k];
+		for(metric=0; metric<NMETRICS; metric++){
+		    if(!(c->values[metric] = calloc(m.reps, sizeof(double)))){
+			perror("Failed to allocate results");
+			exit(EXIT_FAILURE);
+		    }
+		}
+	    }
+	}
+    }
+
+    if(outputFilename && !(out = fopen(outputFilename, "w"))){
+	perror("Failed to open output file");
+	exit(EXIT_FAILURE);
+    }
+    if(jsonFilename && !(jsonOut = fopen(jsonFilename, "w"))){
+	perror("Failed to open JSON file");
+	exit(EXIT_FAILURE);
+    }
+
+    /* One pass over the matrix per repetition */
+    for(rep=0; rep<m.reps; rep++){
+	for(i=0; i<ncells; i++){
+	    cell* c = &cells[i];
+	    int rv = run_once(&m, c);
+	    done++;
+	    if(!quiet){
+		fprintf(stderr, "[%d/%d] %s %s %d: ", done, ncells * m.reps,
+			c->w->name, c->policy, c->procs);
+		if(rv){
+		    fprintf(stderr, "failed\n");
+		}
+		else{
+		    fprintf(stderr, "%.3fs\n", c->values[M_WALL][c->ok - 1]);
+		}
+	    }
+	}
+    }
+
+    if(json){
+	write_json(out, &m, cells, ncells);
+    }
+    else{
+	write_csv(out, cells, ncells);
+    }
+    if(out != stdout && fclose(out)){
+	perror("Failed to close output file");
+	exit(EXIT_FAILURE);
+    }
+    if(jsonOut){
+	write_json(jsonOut, &m, cells, ncells);
+	if(fclose(jsonOut)){
+	    perror("Failed to close JSON file");
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    for(i=0; i<ncells; i++){
+	for(k=0; k<NMETRICS; k++){
+	    free(cells[i].values[k]);
+	}
+    }
+    free(cells);
+
+    return EXIT_SUCCESS;
+}
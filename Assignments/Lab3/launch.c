@@ -0,0 +1,344 @@
+/*
+ * File: launch.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the sequential and concurrent (start
+ *      barrier) child launchers for the scheduling workloads, and the
+ *      per-child timing they report.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "launch.h"
+#include "stats.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+/* In a child: where to record its exit */
+static launch_shared* childShared;
+static int childIndex;
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int launch_init(launch* l, int mode, int nchildren){
+    pthread_barrierattr_t attr;
+
+    l->mode = mode;
+    l->nchildren = nchildren;
+    l->started = 0;
+    l->failed = 0;
+    l->release = 0;
+    l->setup = NULL;
+    l->setupArg = NULL;
+    l->pids = calloc(nchildren, sizeof(*l->pids));
+    l->spawned = calloc(nchildren, sizeof(*l->spawned));
+    l->completed = calloc(nchildren, sizeof(*l->completed));
+    if(!l->pids || !l->spawned || !l->completed){
+	perror("Failed to allocate child table");
+	return LAUNCH_FAILURE;
+    }
+
+    /* the children write their first run and exit times here */
+    l->sharedSize = sizeof(*l->shared) + 2 * nchildren * sizeof(double);
+    l->shared = mmap(NULL, l->sharedSize, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(l->shared == MAP_FAILED){
+	perror("Failed to map shared child table");
+	l->shared = NULL;
+	return LAUNCH_FAILURE;
+    }
+    l->shared->nchildren = nchildren;
+    if(mode == LAUNCH_SEQUENTIAL){
+	return LAUNCH_SUCCESS;
+    }
+
+    /* every child and the parent meet here */
+    if(pthread_barrierattr_init(&attr) ||
+       pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) ||
+       pthread_barrier_init(&l->shared->barrier, &attr, nchildren + 1)){
+	fprintf(stderr, "Failed to set up start barrier\n");
+	return LAUNCH_FAILURE;
+    }
+    pthread_barrierattr_destroy(&attr);
+    return LAUNCH_SUCCESS;
+}
+
+/* atexit in a child, its own clock is not held up behind other
+ * children the way the parent's wakeup can be under SCHED_FIFO/RR */
+static void record_exit(void){
+    childShared->firstRun[childShared->nchildren + childIndex] = now();
+}
+
+void launch_child_setup(launch* l, int (*setup)(int index, void* arg), void* arg){
+    l->setup = setup;
+    l->setupArg = arg;
+}
+
+static void reaped(launch* l, int status){
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+	l->failed++;
+    }
+}
+
+pid_t launch_fork(launch* l){
+    int index = l->started;
+    pid_t pid;
+    int status;
+    int i;
+
+    /* anything still buffered would be printed again by the child */
+    fflush(NULL);
+    l->spawned[index] = now();
+    pid = fork();
+    if(pid == 0){
+	status = l->setup ? l->setup(index, l->setupArg) : 0;
+	if(l->mode == LAUNCH_CONCURRENT){
+	    pthread_barrier_wait(&l->shared->barrier);
+	}
+	if(status){
+	    _exit(EXIT_FAILURE);
+	}
+	l->shared->firstRun[index] = now();
+	childShared = l->shared;
+	childIndex = index;
+	atexit(record_exit);
+	return 0;
+    }
+    if(pid < 0){
+	perror("Error creating child process");
+	/* the barrier will never fill, do not leave them waiting.
+	 * Sequential children are reaped already, their pids may be
+	 * someone else's by now. */
+	if(l->mode == LAUNCH_CONCURRENT){
+	    for(i=0; i<l->started; i++){
+		kill(l->pids[i], SIGKILL);
+		waitpid(l->pids[i], NULL, 0);
+	    }
+	    l->started = 0;
+	}
+	return LAUNCH_FAILURE;
+    }
+
+    l->pids[l->started++] = pid;
+    if(l->mode == LAUNCH_SEQUENTIAL){
+	if(waitpid(pid, &status, 0) == pid){
+	    l->completed[index] = now();
+	    reaped(l, status);
+	}
+    }
+    return pid;
+}
+
+/* Reap with wait, when pidfds are not available */
+static void wait_all(launch* l, int left){
+    int status;
+    pid_t pid;
+    int i;
+
+    while(left > 0){
+	pid = wait(&status);
+	if(pid < 0){
+	    perror("Error waiting for children");
+	    return;
+	}
+	for(i=0; i<l->started; i++){
+	    if(l->pids[i] == pid){
+		l->completed[i] = now();
+		break;
+	    }
+	}
+	reaped(l, status);
+	left--;
+    }
+}
+
+/* One pidfd per child in an epoll set, each polls readable when its
+ * child exits. Falls back to wait without pidfd_open or enough fds.
+ */
+static int open_pidfds(launch* l, int* epfd, int* fds){
+    struct epoll_event ev;
+    struct rlimit rl;
+    int i;
+
+    /* a thousand children need a thousand fds */
+    if(!getrlimit(RLIMIT_NOFILE, &rl) && rl.rlim_cur < rl.rlim_max){
+	rl.rlim_cur = rl.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    *epfd = epoll_create1(EPOLL_CLOEXEC);
+    if(*epfd < 0){
+	return LAUNCH_FAILURE;
+    }
+    for(i=0; i<l->started; i++){
+	fds[i] = syscall(SYS_pidfd_open, l->pids[i], 0);
+	ev.events = EPOLLIN;
+	ev.data.u32 = i;
+	if(fds[i] < 0 || epoll_ctl(*epfd, EPOLL_CTL_ADD, fds[i], &ev)){
+	    if(fds[i] >= 0){
+		close(fds[i]);
+	    }
+	    while(i-- > 0){
+		close(fds[i]);
+	    }
+	    close(*epfd);
+	    return LAUNCH_FAILURE;
+	}
+    }
+    return LAUNCH_SUCCESS;
+}
+
+int launch_wait(launch* l){
+    struct epoll_event events[LAUNCH_EVENTS];
+    int* fds;
+    int epfd;
+    int left = l->started;
+    int status;
+    int n;
+    int i;
+
+    if(l->mode == LAUNCH_SEQUENTIAL){
+	return l->failed;
+    }
+
+    fds = malloc(l->started * sizeof(*fds) + 1);
+    if(!fds || open_pidfds(l, &epfd, fds) == LAUNCH_FAILURE){
+	free(fds);
+	fds = NULL;
+    }
+
+    /* the last one in, the children all start now */
+    l->release = now();
+    pthread_barrier_wait(&l->shared->barrier);
+
+    if(!fds){
+	wait_all(l, left);
+	return l->failed;
+    }
+    while(left > 0){
+	n = epoll_wait(epfd, events, LAUNCH_EVENTS, -1);
+	if(n < 0){
+	    if(errno == EINTR){
+		continue;
+	    }
+	    perror("Error polling children");
+	    break;
+	}
+	for(i=0; i<n; i++){
+	    int c = events[i].data.u32;
+	    l->completed[c] = now();
+	    if(waitpid(l->pids[c], &status, 0) == l->pids[c]){
+		reaped(l, status);
+	    }
+	    close(fds[c]);
+	    left--;
+	}
+    }
+    close(epfd);
+    free(fds);
+    if(left > 0){
+	wait_all(l, left);
+    }
+    return l->failed;
+}
+
+static double child_start(const launch* l, int i){
+    return l->mode == LAUNCH_CONCURRENT ? l->release : l->spawned[i];
+}
+
+/* The child's own exit time, or when it was reaped if it left without
+ * running atexit handlers */
+static double child_end(const launch* l, int i){
+    double end = l->shared->firstRun[l->nchildren + i];
+
+    return end == 0 ? l->completed[i] : end;
+}
+
+void launch_child_times(const launch* l, int i, double* firstRun, double* turnaround){
+    double start = child_start(l, i);
+
+    *firstRun = l->shared->firstRun[i] - start;
+    *turnaround = child_end(l, i) - start;
+}
+
+void launch_report(const launch* l, FILE* fp){
+    int n = l->started;
+    double* turnaround;
+    double* firstRun;
+    double* rate;
+    double first = 0;
+    double last = 0;
+    double start;
+    double end;
+    int i;
+
+    turnaround = malloc(n * sizeof(double) + 1);
+    firstRun = malloc(n * sizeof(double) + 1);
+    rate = malloc(n * sizeof(double) + 1);
+    if(!turnaround || !firstRun || !rate){
+	perror("Failed to allocate report");
+	free(turnaround);
+	free(firstRun);
+	free(rate);
+	return;
+    }
+    for(i=0; i<n; i++){
+	start = child_start(l, i);
+	end = child_end(l, i);
+	launch_child_times(l, i, &firstRun[i], &turnaround[i]);
+	rate[i] = turnaround[i] > 0 ? 1.0 / turnaround[i] : 0;
+	if(i == 0 || start < first){
+	    first = start;
+	}
+	if(end > last){
+	    last = end;
+	}
+    }
+    stats_sort(turnaround, n);
+    stats_sort(firstRun, n);
+
+    fprintf(fp, "launch: children=%d makespan=%.6f turnaround_p50=%.6f "
+	    "turnaround_p90=%.6f turnaround_p99=%.6f turnaround_max=%.6f "
+	    "first_run_p50=%.6f first_run_max=%.6f jain=%.4f\n",
+	    n, last - first,
+	    stats_percentile(turnaround, n, 50), stats_percentile(turnaround, n, 90),
+	    stats_percentile(turnaround, n, 99), stats_percentile(turnaround, n, 100),
+	    stats_percentile(firstRun, n, 50), stats_percentile(firstRun, n, 100),
+	    stats_jain(rate, n));
+    free(turnaround);
+    free(firstRun);
+    free(rate);
+}
+
+void launch_cleanup(launch* l){
+    if(l->shared){
+	if(l->mode == LAUNCH_CONCURRENT){
+	    pthread_barrier_destroy(&l->shared->barrier);
+	}
+	munmap(l->shared, l->sharedSize);
+    }
+    free(l->pids);
+    free(l->spawned);
+    free(l->completed);
+}
@@ -0,0 +1,108 @@
+/*
+ * File: launch.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for starting the children of pi-sched,
+ *      rw and mixed. LAUNCH_SEQUENTIAL is the old loop: fork one
+ *      child, wait for it, fork the next, so only one ever runs.
+ *      LAUNCH_CONCURRENT forks all of them first. Each child waits at
+ *      a barrier in shared memory until the last one is forked, the
+ *      parent releases them together, and then reaps them in the
+ *      order they finish, so they really compete for the cpu.
+ *
+ *      Every child is timed. A child's start is its fork, or the
+ *      release with LAUNCH_CONCURRENT. It writes the time it first
+ *      runs into shared memory, and its exit time from an atexit
+ *      handler. The parent reaps them as their pidfds poll readable in
+ *      epoll (or as wait returns them, on kernels without pidfd_open)
+ *      and uses that reap time only for a child that left with _exit:
+ *      under SCHED_FIFO/RR the parent waits behind the children for
+ *      the cpu, so its wakeups can come long after they finished.
+ *
+ *      first run    first time on a cpu - start
+ *      turnaround   completion - start
+ *      makespan     last completion - first start
+ *      jain         Jain's fairness index of 1 / turnaround, the
+ *                   rate each child got through its (equal) work
+ *
+ */
+
+#ifndef LAUNCH_H
+#define LAUNCH_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#define LAUNCH_FAILURE -1
+#define LAUNCH_SUCCESS 0
+
+#define LAUNCH_SEQUENTIAL 0
+#define LAUNCH_CONCURRENT 1
+
+#define LAUNCH_EVENTS 64            /* epoll events taken per call */
+
+/* What the children write, in memory shared with the parent */
+typedef struct launch_shared_s{
+    pthread_barrier_t barrier;  /* LAUNCH_CONCURRENT only */
+    int nchildren;
+    double firstRun[];          /* per child, CLOCK_MONOTONIC seconds,
+				   then nchildren exit times */
+} launch_shared;
+
+typedef struct launch_s{
+    int mode;
+    int nchildren;              /* how many will be forked */
+    int started;
+    pid_t* pids;
+    launch_shared* shared;
+    size_t sharedSize;
+    double* spawned;            /* fork time */
+    double* completed;          /* reap time */
+    double release;             /* LAUNCH_CONCURRENT: barrier opened */
+    int failed;                 /* children that did not exit 0 */
+    int (*setup)(int index, void* arg);
+    void* setupArg;
+} launch;
+
+/* Function to prepare for nchildren children in mode
+ * Returns LAUNCH_SUCCESS or LAUNCH_FAILURE
+ */
+int launch_init(launch* l, int mode, int nchildren);
+
+/* Function to have each child call setup(index, arg) as soon as it is
+ * forked, before the start barrier. A child whose setup does not
+ * return 0 still meets the barrier, then exits with EXIT_FAILURE.
+ */
+void launch_child_setup(launch* l, int (*setup)(int index, void* arg), void* arg);
+
+/* Function to fork the next child. Sequential: returns in the parent
+ * once that child has exited. Concurrent: the child returns only
+ * when every child is forked and launch_wait releases them. On a
+ * failed fork the children already forked are killed.
+ * Returns 0 in the child, its pid in the parent, or LAUNCH_FAILURE
+ */
+pid_t launch_fork(launch* l);
+
+/* Function to release the children (concurrent mode) and reap every
+ * one of them as they finish
+ * Returns how many did not exit with status 0
+ */
+int launch_wait(launch* l);
+
+/* Function to print one summary line for the run, after launch_wait:
+ * "launch: children=N makespan=S turnaround_p50=S turnaround_p90=S
+ * turnaround_p99=S turnaround_max=S first_run_p50=S first_run_max=S
+ * jain=J", times in seconds */
+void launch_report(const launch* l, FILE* fp);
+
+/* Function to get child i's first run and turnaround, in seconds
+ * from its start, after launch_wait */
+void launch_child_times(const launch* l, int i, double* firstRun, double* turnaround);
+
+/* Function to free what launch_init set up */
+void launch_cleanup(launch* l);
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * File: pi-bench.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	Samples per second of every pi kernel this cpu can run, next
+ *      to the old random() and sqrt(pow()) loop. The kernels must all
+ *      count the same number of hits for the same seed.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "pi-kernel.h"
+
+#define USAGE "[samples]"
+#define DEFAULT_SAMPLES 200000000
+#define LIBC_SHARE 20          /* the libc loop gets 1/20 of the samples */
+#define RADIUS (RAND_MAX / 2)
+#define SEED 3753
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* What pi.c did before the kernel */
+static uint64_t count_libc(uint64_t samples){
+    uint64_t hits = 0;
+    uint64_t i;
+    double x, y;
+
+    for(i=0; i<samples; i++){
+	x = (random() % (RADIUS * 2)) - RADIUS;
+	y = (random() % (RADIUS * 2)) - RADIUS;
+	if(sqrt(pow(x, 2) + pow(y, 2)) < RADIUS){
+	    hits++;
+	}
+    }
+    return hits;
+}
+
+static void report(const char* name, uint64_t samples, uint64_t hits, double secs){
+    fprintf(stdout, "%-8s %12.0f samples/s  %6.2fns/sample  pi = %f\n",
+	    name, samples / secs, 1e9 * secs / samples,
+	    pi_estimate(hits, samples));
+}
+
+int main(int argc, char* argv[]){
+
+    static const int kernels[] = { PI_KERNEL_SCALAR, PI_KERNEL_AVX2, PI_KERNEL_AVX512 };
+    long samples = DEFAULT_SAMPLES;
+    uint64_t first = 0;
+    uint64_t hits;
+    pi_rng rng;
+    double start;
+    size_t k;
+    int ran = 0;
+    int rv = EXIT_SUCCESS;
+
+    if(argc > 1){
+	samples = atol(argv[1]);
+    }
+    if(samples < 1){
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	exit(EXIT_FAILURE);
+    }
+
+    for(k=0; k<sizeof(kernels)/sizeof(kernels[0]); k++){
+	if(pi_kernel_select(kernels[k]) == PI_KERNEL_FAILURE){
+	    continue;
+	}
+	/* untimed pass, so clock ramp-up is not charged to scalar */
+	pi_rng_seed(&rng, SEED, 0);
+	pi_kernel_count(&rng, samples / LIBC_SHARE);
+
+	pi_rng_seed(&rng, SEED, 0);
+	start = now();
+	hits = pi_kernel_count(&rng, samples);
+	report(pi_kernel_name(), samples, hits, now() - start);
+	if(ran++ && hits != first){
+	    fprintf(stderr, "%s counted %llu hits, the kernel before it %llu\n", pi_kernel_name(),
+		    (unsigned long long)hits, (unsigned long long)first);
+	    rv = EXIT_FAILURE;
+	}
+	first = hits;
+    }
+
+    start = now();
+    hits = count_libc(samples / LIBC_SHARE);
+    report("libc", samples / LIBC_SHARE, hits, now() - start);
+
+    pi_kernel_select(PI_KERNEL_AUTO);
+    fprintf(stdout, "selected: %s\n", pi_kernel_name());
+
+    return rv;
+}
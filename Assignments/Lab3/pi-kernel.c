@@ -0,0 +1,251 @@
+/*
+ * File: pi-kernel.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the scalar, AVX2 and AVX-512 Monte Carlo pi
+ *      kernels and the runtime choice between them. The vector
+ *      kernels are compiled with target attributes, so the default
+ *      build flags still run on any x86-64 (or non x86) machine.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "pi-kernel.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PI_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+/* (2^31)^2, the squared radius */
+#define PI_R2 (1ULL << 62)
+#define PI_MASK31 0x7fffffffULL
+
+/* xorshift128+ jump polynomial, 2^64 steps ahead */
+static const uint64_t jumpPoly[2] = { 0x8a5cd789635d2dffULL, 0x121fd2155c472f96ULL };
+
+typedef uint64_t (*pi_count_fn)(pi_rng* rng, uint64_t groups);
+
+static uint64_t count_scalar(pi_rng* rng, uint64_t groups);
+static pi_count_fn countGroups = count_scalar;
+static int kernelId = PI_KERNEL_SCALAR;
+
+static inline uint64_t next_state(uint64_t* a, uint64_t* b){
+    uint64_t x = *a;
+    uint64_t y = *b;
+
+    *a = y;
+    x ^= x << 23;
+    *b = x ^ y ^ (x >> 18) ^ (y >> 5);
+    return *b + y;
+}
+
+/* A point is the top 31 bits and bits 1 to 31 of one output */
+static inline int in_circle(uint64_t r){
+    uint64_t x = r >> 33;
+    uint64_t y = (r >> 1) & PI_MASK31;
+
+    return x * x + y * y < PI_R2;
+}
+
+static uint64_t splitmix64(uint64_t* x){
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void jump(uint64_t* a, uint64_t* b){
+    uint64_t ja = 0;
+    uint64_t jb = 0;
+    int i;
+    int bit;
+
+    for(i=0; i<2; i++){
+	for(bit=0; bit<64; bit++){
+	    if(jumpPoly[i] & (1ULL << bit)){
+		ja ^= *a;
+		jb ^= *b;
+	    }
+	    next_state(a, b);
+	}
+    }
+    *a = ja;
+    *b = jb;
+}
+
+void pi_rng_seed(pi_rng* rng, uint64_t seed, uint64_t stream){
+    uint64_t a = splitmix64(&seed);
+    uint64_t b = splitmix64(&seed);
+    uint64_t n;
+    int i;
+
+    if(!a && !b){
+	b = 1;
+    }
+    for(n=0; n<stream * PI_LANES; n++){
+	jump(&a, &b);
+    }
+    for(i=0; i<PI_LANES; i++){
+	rng->s0[i] = a;
+	rng->s1[i] = b;
+	jump(&a, &b);
+    }
+}
+
+/* groups of PI_LANES samples, one per lane */
+static uint64_t count_scalar(pi_rng* rng, uint64_t groups){
+    uint64_t hits = 0;
+    uint64_t g;
+    int i;
+
+    for(g=0; g<groups; g++){
+	for(i=0; i<PI_LANES; i++){
+	    hits += in_circle(next_state(&rng->s0[i], &rng->s1[i]));
+	}
+    }
+    return hits;
+}
+
+#ifdef PI_HAVE_X86
+
+/* One xorshift128+ step and circle test on 4 lanes, inside lanes
+ * subtract -1 from acc */
+#define AVX2_STEP(a, b, acc) do{					\
+	__m256i x_ = (a);						\
+	__m256i y_ = (b);						\
+	__m256i r_, px_, py_, d_;					\
+	(a) = y_;							\
+	x_ = _mm256_xor_si256(x_, _mm256_slli_epi64(x_, 23));		\
+	(b) = _mm256_xor_si256(_mm256_xor_si256(x_, y_),		\
+			       _mm256_xor_si256(_mm256_srli_epi64(x_, 18), \
+						_mm256_srli_epi64(y_, 5))); \
+	r_ = _mm256_add_epi64((b), y_);					\
+	px_ = _mm256_srli_epi64(r_, 33);				\
+	py_ = _mm256_and_si256(_mm256_srli_epi64(r_, 1), mask31);	\
+	d_ = _mm256_add_epi64(_mm256_mul_epu32(px_, px_),		\
+			      _mm256_mul_epu32(py_, py_));		\
+	(acc) = _mm256_sub_epi64((acc), _mm256_cmpgt_epi64(r2, d_));	\
+    }while(0)
+
+__attribute__((target("avx2")))
+static uint64_t count_avx2(pi_rng* rng, uint64_t groups){
+    const __m256i mask31 = _mm256_set1_epi64x(PI_MASK31);
+    const __m256i r2 = _mm256_set1_epi64x(PI_R2);
+    __m256i a0 = _mm256_load_si256((const __m256i*)&rng->s0[0]);
+    __m256i a1 = _mm256_load_si256((const __m256i*)&rng->s0[4]);
+    __m256i b0 = _mm256_load_si256((const __m256i*)&rng->s1[0]);
+    __m256i b1 = _mm256_load_si256((const __m256i*)&rng->s1[4]);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    uint64_t sums[4] __attribute__((aligned(32)));
+    uint64_t g;
+
+    for(g=0; g<groups; g++){
+	AVX2_STEP(a0, b0, acc0);
+	AVX2_STEP(a1, b1, acc1);
+    }
+    _mm256_store_si256((__m256i*)&rng->s0[0], a0);
+    _mm256_store_si256((__m256i*)&rng->s0[4], a1);
+    _mm256_store_si256((__m256i*)&rng->s1[0], b0);
+    _mm256_store_si256((__m256i*)&rng->s1[4], b1);
+    _mm256_store_si256((__m256i*)sums, _mm256_add_epi64(acc0, acc1));
+    return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+__attribute__((target("avx512f")))
+static uint64_t count_avx512(pi_rng* rng, uint64_t groups){
+    const __m512i mask31 = _mm512_set1_epi64(PI_MASK31);
+    const __m512i r2 = _mm512_set1_epi64(PI_R2);
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512i a = _mm512_load_si512(rng->s0);
+    __m512i b = _mm512_load_si512(rng->s1);
+    __m512i acc = _mm512_setzero_si512();
+    uint64_t g;
+
+    for(g=0; g<groups; g++){
+	__m512i x = a;
+	__m512i y = b;
+	__m512i r, px, py, d;
+	__mmask8 inside;
+
+	a = y;
+	x = _mm512_xor_si512(x, _mm512_slli_epi64(x, 23));
+	b = _mm512_ternarylogic_epi64(x, y, _mm512_xor_si512(_mm512_srli_epi64(x, 18),
+							     _mm512_srli_epi64(y, 5)),
+				      0x96); /* x ^ y ^ z */
+	r = _mm512_add_epi64(b, y);
+	px = _mm512_srli_epi64(r, 33);
+	py = _mm512_and_si512(_mm512_srli_epi64(r, 1), mask31);
+	d = _mm512_add_epi64(_mm512_mul_epu32(px, px), _mm512_mul_epu32(py, py));
+	inside = _mm512_cmplt_epu64_mask(d, r2);
+	acc = _mm512_mask_add_epi64(acc, inside, acc, one);
+    }
+    _mm512_store_si512(rng->s0, a);
+    _mm512_store_si512(rng->s1, b);
+    return _mm512_reduce_add_epi64(acc);
+}
+
+#endif
+
+int pi_kernel_select(int kernel){
+#ifdef PI_HAVE_X86
+    __builtin_cpu_init();
+    if(kernel == PI_KERNEL_AUTO){
+	kernel = __builtin_cpu_supports("avx512f") ? PI_KERNEL_AVX512 :
+	    __builtin_cpu_supports("avx2") ? PI_KERNEL_AVX2 : PI_KERNEL_SCALAR;
+    }
+    if(kernel == PI_KERNEL_AVX512 && __builtin_cpu_supports("avx512f")){
+	countGroups = count_avx512;
+	kernelId = kernel;
+	return PI_KERNEL_SUCCESS;
+    }
+    if(kernel == PI_KERNEL_AVX2 && __builtin_cpu_supports("avx2")){
+	countGroups = count_avx2;
+	kernelId = kernel;
+	return PI_KERNEL_SUCCESS;
+    }
+#else
+    if(kernel == PI_KERNEL_AUTO){
+	kernel = PI_KERNEL_SCALAR;
+    }
+#endif
+    if(kernel == PI_KERNEL_SCALAR){
+	countGroups = count_scalar;
+	kernelId = kernel;
+	return PI_KERNEL_SUCCESS;
+    }
+    return PI_KERNEL_FAILURE;
+}
+
+const char* pi_kernel_name(void){
+    switch(kernelId){
+    case PI_KERNEL_AVX2:
+	return "avx2";
+    case PI_KERNEL_AVX512:
+	return "avx512";
+    default:
+	return "scalar";
+    }
+}
+
+uint64_t pi_kernel_count(pi_rng* rng, uint64_t samples){
+    uint64_t hits = countGroups(rng, samples / PI_LANES);
+    uint64_t i;
+
+    /* what is left over comes from the first lanes, the same way in
+     * every kernel */
+    for(i=0; i<samples % PI_LANES; i++){
+	hits += in_circle(next_state(&rng->s0[i], &rng->s1[i]));
+    }
+    return hits;
+}
+
+double pi_estimate(uint64_t inCircle, uint64_t samples){
+    return 4.0 * (double)inCircle / (double)samples;
+}
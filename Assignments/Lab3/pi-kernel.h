@@ -0,0 +1,67 @@
+/*
+ * File: pi-kernel.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the Monte Carlo pi kernel shared
+ *      by pi, pi-sched and mixed. Samples come from PI_LANES
+ *      independent xorshift128+ generators instead of random(), which
+ *      takes a lock inside glibc on every call. Each 64 bit output is
+ *      one point: two 31 bit coordinates in the quarter circle of
+ *      radius 2^31, tested with integer math as x*x + y*y < R*R.
+ *
+ *      The lanes are stepped side by side, with AVX-512 (8 lanes per
+ *      instruction), AVX2 (4) or plain C, picked at runtime by what
+ *      the cpu supports. All three give the same count for the same
+ *      seed, so they can be checked against each other.
+ *
+ */
+
+#ifndef PI_KERNEL_H
+#define PI_KERNEL_H
+
+#include <stdint.h>
+
+#define PI_KERNEL_FAILURE -1
+#define PI_KERNEL_SUCCESS 0
+
+#define PI_LANES 8
+
+/* kernels, PI_KERNEL_AUTO takes the widest one the cpu has */
+#define PI_KERNEL_AUTO 0
+#define PI_KERNEL_SCALAR 1
+#define PI_KERNEL_AVX2 2
+#define PI_KERNEL_AVX512 3
+
+/* Generator state, one xorshift128+ per lane, lanes side by side */
+typedef struct pi_rng_s{
+    uint64_t s0[PI_LANES] __attribute__((aligned(64)));
+    uint64_t s1[PI_LANES] __attribute__((aligned(64)));
+} pi_rng;
+
+/* Function to seed the lanes of one stream. Lane i of stream n
+ * starts 2^64 * (n * PI_LANES + i) outputs into the sequence for
+ * seed, so no two lanes of any streams overlap in practice.
+ */
+void pi_rng_seed(pi_rng* rng, uint64_t seed, uint64_t stream);
+
+/* Function to pick the kernel, PI_KERNEL_AUTO unless testing one.
+ * Called once before any counting, not thread safe.
+ * Returns PI_KERNEL_SUCCESS, or PI_KERNEL_FAILURE if the cpu (or the
+ * compiler) does not have that kernel
+ */
+int pi_kernel_select(int kernel);
+
+/* Function to name the selected kernel */
+const char* pi_kernel_name(void);
+
+/* Function to draw samples points from rng
+ * Returns how many landed inside the circle
+ */
+uint64_t pi_kernel_count(pi_rng* rng, uint64_t samples);
+
+/* Function to turn a count into an estimate of pi */
+double pi_estimate(uint64_t inCircle, uint64_t samples);
+
+#endif
@@ -4,6 +4,7 @@
  * Project: CSCI 3753 Programming Assignment 3
  * Create Date: 2012/03/07
  * Modify Date: 2012/03/09
+ * Modify Date: 2026/10/19
  * Description:
  *  This file contains a simple program for statistically
  *      calculating pi using a specific scheduling policy.
@@ -15,49 +16,53 @@
 #include <sched.h>
 #include <unistd.h>
 #include <errno.h>
-#include <math.h>
 #include <fcntl.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
+#include "pi-kernel.h"
+#include "launch.h"
+#include "sched-policy.h"
+
 #define DEFAULT_ITERATIONS 1000000
 #define DEFAULT_NUM_PROCESSES 5
-#define RADIUS (RAND_MAX / 2)
-
-inline double dist(double x0, double y0, double x1, double y1){
-    return sqrt(pow((x1-x0),2) + pow((y1-y0),2));
-}
-
-inline double zeroDist(double x, double y){
-    return dist(0, 0, x, y);
-}
+#define SEED 1
 
 int main(int argc, char* argv[]){
 
-    long i;
     long iterations;
-    struct sched_param param;
-    int policy;
-    double x, y;
-    double inCircle = 0.0;
-    double inSquare = 0.0;
-    double pCircle = 0.0;
+    policy_population policies;
+    pi_rng rng;
+    uint64_t inCircle;
     double piCalc = 0.0;
     int pid; // process id
     int numberOfProcesses; // argument to specify how many processes to spawn 
     int k = 0; // used for loop to create each process
+    int opt;
+    int rv;
+    int mode = LAUNCH_SEQUENTIAL; // -c, start every child at once
+    launch children;
+
+    /* -c forks every child before any starts, see launch.h */
+    while((opt = getopt(argc, argv, "c")) != -1){
+        if(opt == 'c'){
+            mode = LAUNCH_CONCURRENT;
+        }
+        else{
+            exit(EXIT_FAILURE);
+        }
+    }
+    /* the positional arguments follow as before */
+    argv += optind - 1;
+    argc -= optind - 1;
 
     /* Process program arguments to select iterations and policy */
     /* Set default iterations if not supplied */
     if(argc < 2){
     iterations = DEFAULT_ITERATIONS;
     }
-    /* Set default policy if not supplied */
-    if(argc < 3){
-    policy = SCHED_OTHER;
-    }
     /* Set iterations if supplied */
     if(argc > 1){
     iterations = atol(argv[1]);
@@ -66,21 +71,9 @@ int main(int argc, char* argv[]){
         exit(EXIT_FAILURE);
     }
     }
-    /* Set policy if supplied */
-    if(argc > 2){
-        if(!strcmp(argv[2], "SCHED_OTHER")){
-            policy = SCHED_OTHER;
-        }
-        else if(!strcmp(argv[2], "SCHED_FIFO")){
-            policy = SCHED_FIFO;
-        }
-        else if(!strcmp(argv[2], "SCHED_RR")){
-            policy = SCHED_RR;
-        }
-        else{
-            fprintf(stderr, "Unhandeled scheduling policy\n");
-            exit(EXIT_FAILURE);
-        }
+    /* Set policy if supplied, see sched-policy.h */
+    if(policy_parse(&policies, argc > 2 ? argv[2] : "SCHED_OTHER") == POLICY_FAILURE){
+        exit(EXIT_FAILURE);
     }
 
     if(argc > 3) {
@@ -93,34 +86,29 @@ int main(int argc, char* argv[]){
         numberOfProcesses = DEFAULT_NUM_PROCESSES;
     }
     
-    /* Set process to max prioty for given scheduler */
-    param.sched_priority = sched_get_priority_max(policy);
-    
-    /* Set new scheduler policy */
-    fprintf(stdout, "Current Scheduling Policy: %d\n", sched_getscheduler(0));
-    fprintf(stdout, "Setting Scheduling Policy to: %d\n", policy);
-    if(sched_setscheduler(0, policy, &param)){
-    perror("Error setting scheduler policy");
-    exit(EXIT_FAILURE);
+    /* Each child sets its own class, fail here if we cannot */
+    policy_print(&policies, numberOfProcesses, stdout);
+    if(policy_check(&policies) == POLICY_FAILURE){
+        exit(EXIT_FAILURE);
     }
-    fprintf(stdout, "New Scheduling Policy: %d\n", sched_getscheduler(0));
 
+    /* Children inherit the kernel picked here */
+    pi_kernel_select(PI_KERNEL_AUTO);
+
+    if(launch_init(&children, mode, numberOfProcesses) == LAUNCH_FAILURE){
+        exit(EXIT_FAILURE);
+    }
+    launch_child_setup(&children, policy_child_setup, &policies);
     for(k=0; k<numberOfProcesses; k++) {
-        pid = fork();
+        pid = launch_fork(&children);
         if (pid == 0) { 
-            /* Calculate pi using statistical methode across all iterations*/
-            for(i=0; i<iterations; i++){
-                x = (random() % (RADIUS * 2)) - RADIUS;
-                y = (random() % (RADIUS * 2)) - RADIUS;
-                if(zeroDist(x,y) < RADIUS){
-                    inCircle++;
-                }
-                inSquare++;
-            }
+            /* Calculate pi using statistical methode across all iterations,
+             * each child on its own stream of samples */
+            pi_rng_seed(&rng, SEED, k);
+            inCircle = pi_kernel_count(&rng, iterations);
 
             /* Finish calculation */
-            pCircle = inCircle/inSquare;
-            piCalc = pCircle * 4.0;
+            piCalc = pi_estimate(inCircle, iterations);
 
             /* Print result */
             fprintf(stdout, "pi = %f\n", piCalc);
@@ -128,12 +116,13 @@ int main(int argc, char* argv[]){
             return 0;
         }
         else if (pid < 0){
-            fprintf(stderr, "Error creating child process");
             exit(EXIT_FAILURE);
         }
-        else {
-            wait(NULL);
-        }
     }
-    return 0;
+    /* with -c this is where they all start */
+    rv = launch_wait(&children) ? EXIT_FAILURE : EXIT_SUCCESS;
+    launch_report(&children, stdout);
+    policy_report(&policies, &children, stdout);
+    launch_cleanup(&children);
+    return rv;
 }
@@ -4,39 +4,81 @@
  * Project: CSCI 3753 Programming Assignment 3
  * Create Date: 2012/03/07
  * Modify Date: 2012/03/09
+ * Modify Date: 2026/10/19
  * Description:
  * 	This file contains a simple program for statistically
- *      calculating pi.
+ *      calculating pi. With a thread count, the iterations are split
+ *      into chunks that threads take from a shared counter until none
+ *      are left, so a thread that gets less cpu simply does fewer
+ *      chunks. Each thread draws from its own jump-ahead stream, and
+ *      the counts are added up at the end.
  */
 
 /* Local Includes */
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
 #include <errno.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "pi-kernel.h"
 
 /* Local Defines */
 #define DEFAULT_ITERATIONS 1000000
-#define RADIUS (RAND_MAX / 2)
+#define DEFAULT_THREADS 1
+#define MAX_THREADS 256
+#define CHUNK (1 << 20)
+#define SEED 1
+
+/* Shared by the threads of one run */
+typedef struct pi_work_s{
+    long iterations;
+    long nchunks;
+    long nextChunk;             /* taken with an atomic add */
+} pi_work;
+
+typedef struct pi_thread_s{
+    pthread_t thread;
+    int index;                  /* also its generator stream */
+    pi_work* work;
+    uint64_t inCircle;
+    uint64_t samples;
+    long chunks;
+} pi_thread;
 
 /* Local Functions */
-inline double dist(double x0, double y0, double x1, double y1){
-    return sqrt(pow((x1-x0),2) + pow((y1-y0),2));
-}
+static void* pi_worker(void* arg){
+    pi_thread* t = arg;
+    pi_work* w = t->work;
+    pi_rng rng;
+    long c;
 
-inline double zeroDist(double x, double y){
-    return dist(0, 0, x, y);
+    pi_rng_seed(&rng, SEED, t->index);
+    while((c = __atomic_fetch_add(&w->nextChunk, 1, __ATOMIC_RELAXED)) < w->nchunks){
+	long n = w->iterations - c * CHUNK;
+	if(n > CHUNK){
+	    n = CHUNK;
+	}
+	t->inCircle += pi_kernel_count(&rng, n);
+	t->samples += n;
+	t->chunks++;
+    }
+    return NULL;
 }
 
 int main(int argc, char* argv[]){
 
-    long i;
     long iterations;
-    double x, y;
-    double inCircle = 0.0;
-    double inSquare = 0.0;
+    int threads;
+    int i;
+    int rc;
+    pi_work work;
+    pi_thread* pool;
+    uint64_t inCircle = 0;
+    uint64_t samples = 0;
     double pCircle = 0.0;
     double piCalc = 0.0;
+    double stdErr = 0.0;
 
     /* Process program arguments to select iterations */
     /* Set default iterations if not supplied */
@@ -51,23 +93,66 @@ int main(int argc, char* argv[]){
 	    exit(EXIT_FAILURE);
 	}
     }
+    /* Set threads if supplied */
+    if(argc < 3){
+	threads = DEFAULT_THREADS;
+    }
+    else{
+	threads = atoi(argv[2]);
+	if(threads < 1 || threads > MAX_THREADS){
+	    fprintf(stderr, "Bad threads value\n");
+	    exit(EXIT_FAILURE);
+	}
+    }
 
     /* Calculate pi using statistical methode across all iterations*/
-    for(i=0; i<iterations; i++){
-	x = (random() % (RADIUS * 2)) - RADIUS;
-	y = (random() % (RADIUS * 2)) - RADIUS;
-	if(zeroDist(x,y) < RADIUS){
-	    inCircle++;
+    pi_kernel_select(PI_KERNEL_AUTO);
+    work.iterations = iterations;
+    work.nchunks = (iterations + CHUNK - 1) / CHUNK;
+    work.nextChunk = 0;
+    if(!(pool = calloc(threads, sizeof(*pool)))){
+	perror("Failed to allocate threads");
+	exit(EXIT_FAILURE);
+    }
+    for(i=0; i<threads; i++){
+	pool[i].index = i;
+	pool[i].work = &work;
+	if(threads == 1){
+	    pi_worker(&pool[i]);
+	    break;
+	}
+	rc = pthread_create(&pool[i].thread, NULL, pi_worker, &pool[i]);
+	if(rc){
+	    fprintf(stderr, "Error creating thread: %d\n", rc);
+	    exit(EXIT_FAILURE);
 	}
-	inSquare++;
     }
 
-    /* Finish calculation */
-    pCircle = inCircle/inSquare;
-    piCalc = pCircle * 4.0;
+    /* Add up every thread's counts */
+    for(i=0; i<threads; i++){
+	if(threads > 1){
+	    pthread_join(pool[i].thread, NULL);
+	}
+	inCircle += pool[i].inCircle;
+	samples += pool[i].samples;
+    }
+
+    /* Finish calculation, each sample is a coin flip with
+     * p = pi/4, so the estimate has standard error 4*sqrt(p(1-p)/n) */
+    pCircle = (double)inCircle / samples;
+    piCalc = pi_estimate(inCircle, samples);
+    stdErr = 4.0 * sqrt(pCircle * (1.0 - pCircle) / samples);
 
     /* Print result */
     fprintf(stdout, "pi = %f\n", piCalc);
+    if(argc > 2){
+	fprintf(stdout, "standard error = %f (%llu samples, %s kernel)\n",
+		stdErr, (unsigned long long)samples, pi_kernel_name());
+	for(i=0; i<threads; i++){
+	    fprintf(stdout, "thread %d: %ld chunks\n", i, pool[i].chunks);
+	}
+    }
+    free(pool);
 
     return 0;
 }
@@ -0,0 +1,312 @@
+/*
+ * File: rr_quantum.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains a program for determining the RR quantum.
+ *      It prints what the kernel says (sched_rr_get_interval and
+ *      /proc/sys/kernel/sched_rr_timeslice_ms), then measures it:
+ *      spinners at the same policy and priority are pinned to one
+ *      cpu and started together (launch.c). Each reads the clock in
+ *      a tight loop and marks itself as the owner of the cpu in shared
+ *      memory. Finding another spinner's mark means it was preempted
+ *      between two reads, and the time from taking the cpu back to the
+ *      next such preemption is one quantum it got. A gap between reads
+ *      with no other owner (an interrupt, another task) does not end
+ *      the quantum. The quanta of all spinners are printed as a
+ *      distribution.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "launch.h"
+#include "stats.h"
+
+#define USAGE "[-p SCHED_RR|SCHED_FIFO|SCHED_OTHER] [-n spinners] [-d seconds] [-a cpu]"
+#define DEFAULT_SPINNERS 2
+#define DEFAULT_SECONDS 2.0
+#define MAX_SPINNERS 64
+#define MAXRUNS 65536               /* quanta kept per spinner */
+#define HISTOGRAM_BINS 32           /* powers of two microseconds */
+#define HISTOGRAM_WIDTH 50
+#define TIMESLICE_FILE "/proc/sys/kernel/sched_rr_timeslice_ms"
+
+/* What one spinner saw, in memory shared with the parent */
+typedef struct spinner_s{
+    double interval;            /* sched_rr_get_interval, seconds */
+    int nruns;
+    int ngaps;
+    int dropped;                /* past MAXRUNS */
+    double runs[MAXRUNS];       /* on cpu, seconds */
+    double gaps[MAXRUNS];       /* off cpu, seconds */
+} spinner;
+
+typedef struct spin_shared_s{
+    int owner;                  /* the spinner that last ran */
+    spinner spinners[];
+} spin_shared;
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Spin for seconds, splitting the time into runs wherever another
+ * spinner took the cpu. The first run started at the barrier and the
+ * last is cut off at the end, so neither is a whole quantum and
+ * neither is kept.
+ */
+static void spin(spin_shared* shared, int me, double seconds){
+    spinner* s = &shared->spinners[me];
+    double last = now();
+    double end = last + seconds;
+    double runStart = last;
+    int whole = 0;
+    double t;
+
+    __atomic_store_n(&shared->owner, me, __ATOMIC_RELAXED);
+    while(last < end){
+	t = now();
+	if(__atomic_load_n(&shared->owner, __ATOMIC_RELAXED) != me){
+	    /* the first gap has no run before it, so there is never
+	     * more than one run per gap and this bounds both */
+	    if(s->ngaps < MAXRUNS){
+		if(whole){
+		    s->runs[s->nruns++] = last - runStart;
+		}
+		s->gaps[s->ngaps++] = t - last;
+	    }
+	    else{
+		s->dropped++;
+	    }
+	    whole = 1;
+	    runStart = t;
+	    __atomic_store_n(&shared->owner, me, __ATOMIC_RELAXED);
+	}
+	last = t;
+    }
+}
+
+static void print_summary(const char* name, double* values, int n){
+    stats s;
+
+    stats_compute(values, n, &s);
+    stats_sort(values, n);
+    fprintf(stdout, "%s: n=%d mean=%.3f stddev=%.3f min=%.3f p50=%.3f "
+	    "p90=%.3f p99=%.3f max=%.3f ms\n", name, n,
+	    s.mean * 1e3, s.stddev * 1e3, s.min * 1e3,
+	    stats_percentile(values, n, 50) * 1e3,
+	    stats_percentile(values, n, 90) * 1e3,
+	    stats_percentile(values, n, 99) * 1e3, s.max * 1e3);
+}
+
+/* Counts in power of two bins, [2^b, 2^(b+1)) microseconds */
+static void print_histogram(const double* values, int n){
+    int bins[HISTOGRAM_BINS] = {0};
+    int most = 0;
+    int lo = HISTOGRAM_BINS;
+    int hi = 0;
+    int b;
+    int i;
+
+    for(i=0; i<n; i++){
+	double us = values[i] * 1e6;
+	for(b=0; b<HISTOGRAM_BINS-1 && us >= (double)(2L << b); b++);
+	bins[b]++;
+	if(bins[b] > most){
+	    most = bins[b];
+	}
+	if(b < lo){
+	    lo = b;
+	}
+	if(b > hi){
+	    hi = b;
+	}
+    }
+    for(b=lo; b<=hi; b++){
+	fprintf(stdout, "  [%10.3f, %10.3f) ms %6d ", (1L << b) / 1e3,
+		(2L << b) / 1e3, bins[b]);
+	for(i=0; i<bins[b] * HISTOGRAM_WIDTH / most; i++){
+	    fputc('#', stdout);
+	}
+	fputc('\n', stdout);
+    }
+}
+
+int main(int argc, char* argv[]){
+
+    const char* policyName = "SCHED_RR";
+    struct sched_param param;
+    struct timespec ts;
+    cpu_set_t cpus;
+    spin_shared* shared;
+    spinner* spinners;
+    size_t sharedSize;
+    double seconds = DEFAULT_SECONDS;
+    double* runs;
+    double* gaps;
+    int nspinners = DEFAULT_SPINNERS;
+    int cpu = -1;
+    int policy;
+    int nruns = 0;
+    int ngaps = 0;
+    int dropped = 0;
+    int slice;
+    int opt;
+    int i, j;
+    pid_t pid;
+    launch children;
+    FILE* fp;
+
+    while((opt = getopt(argc, argv, "a:d:n:p:")) != -1){
+	switch(opt){
+	case 'a':
+	    cpu = atoi(optarg);
+	    break;
+	case 'd':
+	    seconds = atof(optarg);
+	    break;
+	case 'n':
+	    nspinners = atoi(optarg);
+	    break;
+	case 'p':
+	    policyName = optarg;
+	    break;
+	default:
+	    fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	    exit(EXIT_FAILURE);
+	}
+    }
+    if(seconds <= 0 || nspinners < 1 || nspinners > MAX_SPINNERS){
+	fprintf(stderr, "Usage:\n %s %s\n", argv[0], USAGE);
+	exit(EXIT_FAILURE);
+    }
+    if(!strcmp(policyName, "SCHED_OTHER")){
+	policy = SCHED_OTHER;
+    }
+    else if(!strcmp(policyName, "SCHED_FIFO")){
+	policy = SCHED_FIFO;
+    }
+    else if(!strcmp(policyName, "SCHED_RR")){
+	policy = SCHED_RR;
+    }
+    else{
+	fprintf(stderr, "Unhandeled scheduling policy\n");
+	exit(EXIT_FAILURE);
+    }
+
+    /* All spinners on one cpu, the one we are on unless -a says */
+    if(cpu < 0){
+	cpu = sched_getcpu();
+	if(cpu < 0){
+	    cpu = 0;
+	}
+    }
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if(sched_setaffinity(0, sizeof(cpus), &cpus)){
+	perror("Error pinning to cpu");
+	exit(EXIT_FAILURE);
+    }
+
+    /* Same policy and priority for every spinner, they inherit it */
+    param.sched_priority = sched_get_priority_max(policy);
+    if(sched_setscheduler(0, policy, &param)){
+	perror("Error setting scheduler policy");
+	exit(EXIT_FAILURE);
+    }
+
+    sharedSize = sizeof(*shared) + nspinners * sizeof(*spinners);
+    shared = mmap(NULL, sharedSize, PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shared == MAP_FAILED){
+	perror("Failed to map shared results");
+	exit(EXIT_FAILURE);
+    }
+    shared->owner = -1;
+    spinners = shared->spinners;
+
+    if(launch_init(&children, LAUNCH_CONCURRENT, nspinners) == LAUNCH_FAILURE){
+	exit(EXIT_FAILURE);
+    }
+    for(i=0; i<nspinners; i++){
+	pid = launch_fork(&children);
+	if(pid == 0){
+	    if(!sched_rr_get_interval(0, &ts)){
+		spinners[i].interval = ts.tv_sec + ts.tv_nsec / 1e9;
+	    }
+	    spin(shared, i, seconds);
+	    return 0;
+	}
+	else if(pid < 0){
+	    exit(EXIT_FAILURE);
+	}
+    }
+    if(launch_wait(&children)){
+	fprintf(stderr, "A spinner failed\n");
+	exit(EXIT_FAILURE);
+    }
+    launch_cleanup(&children);
+
+    /* What the kernel says */
+    fprintf(stdout, "sched_rr_get_interval: %.3f ms\n", spinners[0].interval * 1e3);
+    if((fp = fopen(TIMESLICE_FILE, "r"))){
+	if(fscanf(fp, "%d", &slice) == 1){
+	    fprintf(stdout, "sched_rr_timeslice_ms: %d\n", slice);
+	}
+	fclose(fp);
+    }
+    fprintf(stdout, "%s priority %d, %d spinners on cpu %d for %.1f s\n",
+	    policyName, param.sched_priority, nspinners, cpu, seconds);
+
+    /* What the spinners saw */
+    for(i=0; i<nspinners; i++){
+	nruns += spinners[i].nruns;
+	ngaps += spinners[i].ngaps;
+	dropped += spinners[i].dropped;
+    }
+    if(nruns == 0){
+	fprintf(stdout, "No whole quanta seen, nothing preempted the spinners\n");
+	munmap(shared, sharedSize);
+	return 0;
+    }
+    runs = malloc(nruns * sizeof(double));
+    gaps = malloc(ngaps * sizeof(double));
+    if(!runs || !gaps){
+	perror("Failed to allocate results");
+	exit(EXIT_FAILURE);
+    }
+    nruns = ngaps = 0;
+    for(i=0; i<nspinners; i++){
+	for(j=0; j<spinners[i].nruns; j++){
+	    runs[nruns++] = spinners[i].runs[j];
+	}
+	for(j=0; j<spinners[i].ngaps; j++){
+	    gaps[ngaps++] = spinners[i].gaps[j];
+	}
+    }
+    print_summary("quantum", runs, nruns);
+    print_summary("off cpu", gaps, ngaps);
+    if(dropped){
+	fprintf(stdout, "(%d quanta past %d per spinner not kept)\n", dropped, MAXRUNS);
+    }
+    fprintf(stdout, "quantum distribution:\n");
+    print_histogram(runs, nruns);
+
+    free(runs);
+    free(gaps);
+    munmap(shared, sharedSize);
+    return 0;
+}
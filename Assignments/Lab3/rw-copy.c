@@ -0,0 +1,516 @@
+/*
+ * File: rw-copy.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the copy engines of rw.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+
+#include "rw-copy.h"
+#include "stats.h"
+#include "uring.h"
+
+static const char* engineNames[RWCOPY_ENGINES] = {
+    "read", "copy_file_range", "sendfile", "splice", "mmap", "io_uring"
+};
+
+/* One block in flight in the io_uring engine */
+typedef struct uring_slot_s{
+    char* buffer;
+    off_t block;
+    int writing;                /* 0 while its read is in flight */
+    double submitted;
+} uring_slot;
+
+int rwcopy_engine(const char* name){
+    int i;
+
+    for(i=0; i<RWCOPY_ENGINES; i++){
+	if(!strcmp(engineNames[i], name)){
+	    return i;
+	}
+    }
+    return RWCOPY_FAILURE;
+}
+
+const char* rwcopy_engine_name(int engine){
+    return engine >= 0 && engine < RWCOPY_ENGINES ? engineNames[engine] : "unknown";
+}
+
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double tv_seconds(const struct timeval* tv){
+    return tv->tv_sec + tv->tv_usec / 1e6;
+}
+
+/* The original rw loop: a whole block or start the input over */
+static int copy_read(rwcopy* c){
+    off_t end = c->inputOffset + c->inputLength;
+    off_t offset = c->inputOffset;
+    ssize_t bytesRead;
+    ssize_t bytesWritten;
+
+    do{
+	bytesRead = 0;
+	if(offset + c->blocksize <= end){
+	    bytesRead = pread(c->inputFD, c->buffer, c->blocksize, offset);
+	    c->syscalls++;
+	}
+	if(bytesRead < 0){
+	    perror("Error reading input file");
+	    return RWCOPY_FAILURE;
+	}
+	c->bytesRead += bytesRead;
+	c->reads++;
+
+	if(bytesRead == c->blocksize){
+	    offset += bytesRead;
+	    bytesWritten = write(c->outputFD, c->buffer, bytesRead);
+	    c->syscalls++;
+	    if(bytesWritten < 0){
+		perror("Error writing output file");
+		return RWCOPY_FAILURE;
+	    }
+	    c->bytesWritten += bytesWritten;
+	    c->writes++;
+	}
+	else{
+	    if(offset == c->inputOffset){
+		fprintf(stderr, "Input is smaller than a block\n");
+		return RWCOPY_FAILURE;
+	    }
+	    offset = c->inputOffset;
+	    c->passes++;
+	}
+    }while(c->bytesWritten < c->transfersize);
+    return RWCOPY_SUCCESS;
+}
+
+/* Copy up to len bytes at *offset with the kernel engine, moving it on */
+static ssize_t copy_block(rwcopy* c, int pipeFD[2], off_t* offset, size_t len){
+    ssize_t n;
+    ssize_t out;
+    ssize_t left;
+
+    switch(c->engine){
+    case RWCOPY_COPY_FILE_RANGE:
+	n = copy_file_range(c->inputFD, offset, c->outputFD, NULL, len, 0);
+	c->syscalls++;
+	c->reads++;
+	c->writes++;
+	if(n > 0){
+	    c->bytesWritten += n;
+	}
+	return n;
+    case RWCOPY_SENDFILE:
+	n = sendfile(c->outputFD, c->inputFD, offset, len);
+	c->syscalls++;
+	c->reads++;
+	c->writes++;
+	if(n > 0){
+	    c->bytesWritten += n;
+	}
+	return n;
+    case RWCOPY_SPLICE:
+	n = splice(c->inputFD, offset, pipeFD[1], NULL, len, SPLICE_F_MOVE);
+	c->syscalls++;
+	c->reads++;
+	for(left=n; left>0; left-=out){
+	    out = splice(pipeFD[0], NULL, c->outputFD, NULL, left, SPLICE_F_MOVE);
+	    c->syscalls++;
+	    c->writes++;
+	    if(out <= 0){
+		return -1;
+	    }
+	    c->bytesWritten += out;
+	}
+	return n;
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+static int copy_kernel(rwcopy* c){
+    int pipeFD[2] = { -1, -1 };
+    off_t end = c->inputOffset + c->inputLength;
+    off_t offset = c->inputOffset;
+    size_t done;
+    ssize_t n = 0;
+    int rv = RWCOPY_SUCCESS;
+
+    if(c->engine == RWCOPY_SPLICE){
+	if(pipe(pipeFD)){
+	    perror("Error creating splice pipe");
+	    return RWCOPY_FAILURE;
+	}
+	c->syscalls++;
+	/* a block should fit in the pipe in one go */
+	if(c->blocksize > getpagesize()){
+	    fcntl(pipeFD[1], F_SETPIPE_SZ, c->blocksize);
+	    c->syscalls++;
+	}
+    }
+    while(c->bytesWritten < c->transfersize && rv == RWCOPY_SUCCESS){
+	/* whole blocks like read, a partial one at the end is skipped */
+	if(offset + c->blocksize > end){
+	    offset = c->inputOffset;
+	    c->passes++;
+	}
+	/* the kernel may copy less than asked, finish the block */
+	for(done=0; done<(size_t)c->blocksize; done+=n){
+	    n = copy_block(c, pipeFD, &offset, c->blocksize - done);
+	    if(n < 0){
+		perror("Error copying to output file");
+		rv = RWCOPY_FAILURE;
+		break;
+	    }
+	    if(n == 0){
+		fprintf(stderr, "Input ended inside a block\n");
+		rv = RWCOPY_FAILURE;
+		break;
+	    }
+	    c->bytesRead += n;
+	}
+    }
+    if(pipeFD[0] >= 0){
+	close(pipeFD[0]);
+	close(pipeFD[1]);
+    }
+    return rv;
+}
+
+static int copy_mmap(rwcopy* c){
+    struct stat st;
+    long page = getpagesize();
+    char* input;
+    char* output;
+    off_t end = c->inputOffset + c->inputLength;
+    off_t offset = c->inputOffset;
+    off_t syncStart;
+    size_t len = c->blocksize;
+    int rv = RWCOPY_SUCCESS;
+
+    if(fstat(c->inputFD, &st) || ftruncate(c->outputFD, c->transfersize)){
+	perror("Error sizing files for mmap");
+	return RWCOPY_FAILURE;
+    }
+    c->syscalls += 2;
+    input = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, c->inputFD, 0);
+    output = mmap(NULL, c->transfersize, PROT_READ | PROT_WRITE, MAP_SHARED,
+		  c->outputFD, 0);
+    c->syscalls += 2;
+    if(input == MAP_FAILED || output == MAP_FAILED){
+	perror("Error mapping files");
+	rv = RWCOPY_FAILURE;
+	goto unmap;
+    }
+
+    while(c->bytesWritten < c->transfersize){
+	/* whole blocks like read, a partial one at the end is skipped */
+	if(offset + c->blocksize > end){
+	    offset = c->inputOffset;
+	    c->passes++;
+	}
+	memcpy(output + c->bytesWritten, input + offset, len);
+	c->reads++;
+	/* msync wants a page aligned start */
+	syncStart = c->bytesWritten / page * page;
+	if(msync(output + syncStart, c->bytesWritten + len - syncStart, MS_SYNC)){
+	    perror("Error syncing output file");
+	    rv = RWCOPY_FAILURE;
+	    break;
+	}
+	c->syscalls++;
+	c->writes++;
+	c->bytesRead += len;
+	c->bytesWritten += len;
+	offset += len;
+    }
+
+ unmap:
+    if(input != MAP_FAILED){
+	munmap(input, st.st_size);
+    }
+    if(output != MAP_FAILED){
+	munmap(output, c->transfersize);
+    }
+    return rv;
+}
+
+static void uring_prep(rwcopy* c, struct io_uring_sqe* sqe, uring_slot* slots,
+		       int slot, int fd, off_t offset){
+    int op;
+
+    if(c->registeredBuffers){
+	op = slots[slot].writing ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+	sqe->buf_index = slot;
+    }
+    else{
+	op = slots[slot].writing ? IORING_OP_WRITE : IORING_OP_READ;
+    }
+    sqe->opcode = op;
+    sqe->fd = c->fixedFiles ? (slots[slot].writing ? 1 : 0) : fd;
+    sqe->flags = c->fixedFiles ? IOSQE_FIXED_FILE : 0;
+    sqe->addr = (unsigned long)slots[slot].buffer;
+    sqe->len = c->blocksize;
+    sqe->off = offset;
+    sqe->user_data = slot;
+    slots[slot].submitted = now();
+}
+
+/* Whole blocks like read: the input is used up to its last whole
+ * block, then starts over. Block b is read from b % usable blocks of
+ * the input and written to block b of the output. */
+static int copy_uring(rwcopy* c){
+    struct io_uring_cqe cqe;
+    struct io_uring_sqe* sqe;
+    struct iovec* iov = NULL;
+    uring_slot* slots = NULL;
+    double* latencies = NULL;
+    char* buffers = NULL;
+    int* freeSlots = NULL;
+    int fds[2] = { c->inputFD, c->outputFD };
+    off_t usable;
+    off_t nblocks;
+    off_t next = 0;
+    off_t done = 0;
+    int nfree;
+    int nlatencies = 0;
+    int depth = c->queueDepth > 0 ? c->queueDepth : RWCOPY_DEFAULT_DEPTH;
+    int rv = RWCOPY_FAILURE;
+    int slot;
+    uring r;
+
+    usable = c->inputLength / c->blocksize;
+    nblocks = c->transfersize / c->blocksize;
+    if(depth > nblocks){
+	depth = nblocks;
+    }
+    c->queueDepth = depth;
+
+    if(uring_init(&r, depth * 2, c->sqpoll ? IORING_SETUP_SQPOLL : 0) == URING_FAILURE){
+	perror("Error setting up io_uring");
+	return RWCOPY_FAILURE;
+    }
+    c->syscalls++;
+    slots = calloc(depth, sizeof(*slots));
+    iov = calloc(depth, sizeof(*iov));
+    freeSlots = calloc(depth, sizeof(*freeSlots));
+    latencies = malloc(2 * nblocks * sizeof(*latencies));
+    if(!slots || !iov || !freeSlots || !latencies ||
+       posix_memalign((void**)&buffers, getpagesize(), depth * c->blocksize)){
+	perror("Failed to allocate io_uring buffers");
+	buffers = NULL;
+	goto cleanup;
+    }
+    for(slot=0; slot<depth; slot++){
+	slots[slot].buffer = buffers + slot * c->blocksize;
+	iov[slot].iov_base = slots[slot].buffer;
+	iov[slot].iov_len = c->blocksize;
+	freeSlots[slot] = slot;
+    }
+    nfree = depth;
+    /* without them (RLIMIT_MEMLOCK, old kernels) plain ops still work */
+    c->registeredBuffers = uring_register_buffers(&r, iov, depth) == URING_SUCCESS;
+    c->fixedFiles = uring_register_files(&r, fds, 2) == URING_SUCCESS;
+    c->syscalls += 2;
+
+    while(done < nblocks){
+	/* keep depth blocks in flight */
+	while(nfree > 0 && next < nblocks && (sqe = uring_get_sqe(&r))){
+	    slot = freeSlots[--nfree];
+	    slots[slot].block = next;
+	    slots[slot].writing = 0;
+	    uring_prep(c, sqe, slots, slot, c->inputFD,
+		       c->inputOffset + next % usable * c->blocksize);
+	    if(next > 0 && next % usable == 0){
+		c->passes++;
+	    }
+	    next++;
+	}
+	if(uring_submit(&r, 1) == URING_FAILURE){
+	    perror("Error submitting to io_uring");
+	    goto cleanup;
+	}
+	while(uring_next_cqe(&r, &cqe)){
+	    slot = cqe.user_data;
+	    latencies[nlatencies++] = now() - slots[slot].submitted;
+	    if(cqe.res != c->blocksize){
+		if(cqe.res < 0){
+		    errno = -cqe.res;
+		    perror(slots[slot].writing ? "Error writing output file" :
+			   "Error reading input file");
+		}
+		else{
+		    fprintf(stderr, "Short %s of %d bytes\n",
+			    slots[slot].writing ? "write" : "read", cqe.res);
+		}
+		goto cleanup;
+	    }
+	    if(!slots[slot].writing){
+		c->bytesRead += cqe.res;
+		c->reads++;
+		/* a slot only ever has one entry in the ring */
+		if(!(sqe = uring_get_sqe(&r))){
+		    fprintf(stderr, "io_uring submission ring full\n");
+		    goto cleanup;
+		}
+		slots[slot].writing = 1;
+		uring_prep(c, sqe, slots, slot, c->outputFD, slots[slot].block * c->blocksize);
+	    }
+	    else{
+		c->bytesWritten += cqe.res;
+		c->writes++;
+		freeSlots[nfree++] = slot;
+		done++;
+	    }
+	}
+    }
+    rv = RWCOPY_SUCCESS;
+
+    stats_sort(latencies, nlatencies);
+    c->latencyP50 = stats_percentile(latencies, nlatencies, 50);
+    c->latencyP90 = stats_percentile(latencies, nlatencies, 90);
+    c->latencyP99 = stats_percentile(latencies, nlatencies, 99);
+    c->latencyMax = stats_percentile(latencies, nlatencies, 100);
+
+ cleanup:
+    c->syscalls += r.enters;
+    uring_cleanup(&r);
+    free(buffers);
+    free(latencies);
+    free(freeSlots);
+    free(iov);
+    free(slots);
+    return rv;
+}
+
+int rwcopy_run(rwcopy* c){
+    struct rusage before;
+    struct rusage after;
+    struct stat st;
+    int rv;
+
+    if(c->inputLength == 0){
+	if(fstat(c->inputFD, &st)){
+	    perror("Error sizing input file");
+	    return RWCOPY_FAILURE;
+	}
+	c->inputLength = st.st_size - c->inputOffset;
+    }
+    if(c->inputLength < c->blocksize){
+	fprintf(stderr, "Input is smaller than a block\n");
+	return RWCOPY_FAILURE;
+    }
+
+    c->bytesRead = c->bytesWritten = 0;
+    c->reads = c->writes = 0;
+    c->syscalls = 0;
+    c->passes = 0;
+    c->registeredBuffers = c->fixedFiles = 0;
+    c->latencyP50 = c->latencyP90 = c->latencyP99 = c->latencyMax = 0;
+    getrusage(RUSAGE_SELF, &before);
+    c->startTime = now();
+    switch(c->engine){
+    case RWCOPY_READ:
+	rv = copy_read(c);
+	break;
+    case RWCOPY_MMAP:
+	rv = copy_mmap(c);
+	break;
+    case RWCOPY_URING:
+	rv = copy_uring(c);
+	break;
+    default:
+	rv = copy_kernel(c);
+	break;
+    }
+    c->seconds = now() - c->startTime;
+    getrusage(RUSAGE_SELF, &after);
+    c->userSeconds = tv_seconds(&after.ru_utime) - tv_seconds(&before.ru_utime);
+    c->systemSeconds = tv_seconds(&after.ru_stime) - tv_seconds(&before.ru_stime);
+    return rv;
+}
+
+void rwcopy_print(const rwcopy* c, FILE* fp){
+    fprintf(fp, "copy: engine=%s bytes=%zd seconds=%.6f MB/s=%.2f syscalls=%ld "
+	    "user=%.6f sys=%.6f\n", rwcopy_engine_name(c->engine), c->bytesWritten,
+	    c->seconds, c->seconds > 0 ? c->bytesWritten / c->seconds / 1e6 : 0,
+	    c->syscalls, c->userSeconds, c->systemSeconds);
+    if(c->engine == RWCOPY_URING){
+	fprintf(fp, "uring: depth=%d sqpoll=%d registered_buffers=%d fixed_files=%d "
+		"iops=%.0f latency_p50_us=%.1f latency_p90_us=%.1f latency_p99_us=%.1f "
+		"latency_max_us=%.1f\n", c->queueDepth, c->sqpoll,
+		c->registeredBuffers, c->fixedFiles,
+		c->seconds > 0 ? (c->reads + c->writes) / c->seconds : 0,
+		c->latencyP50 * 1e6, c->latencyP90 * 1e6, c->latencyP99 * 1e6,
+		c->latencyMax * 1e6);
+    }
+}
+
+void rwcopy_share_of(const rwcopy* c, rwcopy_share* share){
+    share->bytes = c->bytesWritten;
+    share->start = c->startTime;
+    share->end = c->startTime + c->seconds;
+}
+
+void rwcopy_aggregate(const rwcopy_share* shares, int n, FILE* fp){
+    double first = 0;
+    double last = 0;
+    double rate;
+    double minRate = 0;
+    double maxRate = 0;
+    double sumRate = 0;
+    ssize_t bytes = 0;
+    int copied = 0;
+    int i;
+
+    for(i=0; i<n; i++){
+	if(shares[i].start == 0){
+	    continue;
+	}
+	rate = shares[i].end > shares[i].start ?
+	    shares[i].bytes / (shares[i].end - shares[i].start) / 1e6 : 0;
+	if(copied == 0 || shares[i].start < first){
+	    first = shares[i].start;
+	}
+	if(shares[i].end > last){
+	    last = shares[i].end;
+	}
+	if(copied == 0 || rate < minRate){
+	    minRate = rate;
+	}
+	if(rate > maxRate){
+	    maxRate = rate;
+	}
+	sumRate += rate;
+	bytes += shares[i].bytes;
+	copied++;
+    }
+    fprintf(fp, "bandwidth: children=%d bytes=%zd seconds=%.6f aggregate_MB/s=%.2f "
+	    "child_MB/s_min=%.2f child_MB/s_mean=%.2f child_MB/s_max=%.2f\n",
+	    copied, bytes, last - first, last > first ? bytes / (last - first) / 1e6 : 0,
+	    minRate, copied ? sumRate / copied : 0, maxRate);
+}
@@ -0,0 +1,126 @@
+/*
+ * File: rw-copy.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the copy engines of rw. Each copies
+ *      transfersize bytes from the input to the output blocksize bytes
+ *      at a time, and counts what it did. Only whole blocks of the
+ *      input are copied: when the next block would run past the end of
+ *      the input (or of its stripe), every engine starts over at the
+ *      top, so a partial last block is never copied and all of them
+ *      write the same bytes:
+ *
+ *      read             read and write through a user buffer (the
+ *                       original rw loop)
+ *      copy_file_range  the kernel copies between the two files
+ *      sendfile         the kernel copies from the input's page cache
+ *      splice           input to a pipe to the output, page references
+ *                       instead of copies where the files allow it
+ *      mmap             memcpy between mappings of the two files, an
+ *                       msync per block for the O_SYNC the others get
+ *      io_uring         queueDepth blocks in flight at once, each read
+ *                       into its own registered buffer and written out
+ *                       from it as soon as the read completes, with
+ *                       both files registered, optionally SQPOLL
+ *
+ *      Comparing them with the same device and O_SYNC shows how much of
+ *      rw's time is the copy itself and how much is waiting on the disk.
+ *
+ *      Every engine reads at offsets of its own (pread for read), never
+ *      through the file offset, so children sharing the input's open
+ *      file do not move each other around in it. The input can be
+ *      limited to a region, a stripe of it for each child.
+ *
+ */
+
+#ifndef RW_COPY_H
+#define RW_COPY_H
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#define RWCOPY_FAILURE -1
+#define RWCOPY_SUCCESS 0
+
+#define RWCOPY_READ 0
+#define RWCOPY_COPY_FILE_RANGE 1
+#define RWCOPY_SENDFILE 2
+#define RWCOPY_SPLICE 3
+#define RWCOPY_MMAP 4
+#define RWCOPY_URING 5
+#define RWCOPY_ENGINES 6
+
+#define RWCOPY_DEFAULT_DEPTH 8
+
+typedef struct rwcopy_s{
+    /* set by the caller */
+    int engine;
+    int inputFD;
+    off_t inputOffset;          /* the region of the input used */
+    off_t inputLength;          /* 0 for all of it */
+    int outputFD;               /* opened O_RDWR for mmap */
+    ssize_t transfersize;       /* a multiple of blocksize */
+    ssize_t blocksize;
+    char* buffer;               /* blocksize bytes, for read */
+    int queueDepth;             /* io_uring: blocks in flight */
+    int sqpoll;                 /* io_uring: kernel submission thread */
+    /* filled in by rwcopy_run */
+    ssize_t bytesRead;
+    ssize_t bytesWritten;
+    int reads;                  /* calls that brought data in */
+    int writes;                 /* calls that put data out */
+    long syscalls;              /* every system call the copy made */
+    int passes;                 /* times through the input */
+    double startTime;           /* CLOCK_MONOTONIC */
+    double seconds;
+    double userSeconds;
+    double systemSeconds;
+    /* io_uring only */
+    int registeredBuffers;      /* 0 if registering them failed */
+    int fixedFiles;
+    double latencyP50;          /* per read or write, seconds */
+    double latencyP90;
+    double latencyP99;
+    double latencyMax;
+} rwcopy;
+
+/* What one child copied, written into memory shared with the parent */
+typedef struct rwcopy_share_s{
+    ssize_t bytes;
+    double start;               /* CLOCK_MONOTONIC, 0 if it never copied */
+    double end;
+} rwcopy_share;
+
+/* Function to look up an engine by name
+ * Returns its RWCOPY_ number, or RWCOPY_FAILURE
+ */
+int rwcopy_engine(const char* name);
+
+/* Function to name an engine */
+const char* rwcopy_engine_name(int engine);
+
+/* Function to copy as set up in c, timing it and its cpu use
+ * Returns RWCOPY_SUCCESS or RWCOPY_FAILURE, with perror, also when
+ * the input has no whole block
+ */
+int rwcopy_run(rwcopy* c);
+
+/* Function to print "copy: engine=E bytes=B seconds=S MB/s=R
+ * syscalls=N user=S sys=S" for a finished copy, and for io_uring
+ * "uring: depth=D sqpoll=0|1 registered_buffers=0|1 fixed_files=0|1
+ * iops=N latency_p50_us=U latency_p90_us=U latency_p99_us=U
+ * latency_max_us=U" */
+void rwcopy_print(const rwcopy* c, FILE* fp);
+
+/* Function to fill in a child's share from its finished copy */
+void rwcopy_share_of(const rwcopy* c, rwcopy_share* share);
+
+/* Function to print "bandwidth: children=N bytes=B seconds=S
+ * aggregate_MB/s=R child_MB/s_min=R child_MB/s_mean=R
+ * child_MB/s_max=R", seconds from the first child starting its copy to
+ * the last finishing */
+void rwcopy_aggregate(const rwcopy_share* shares, int n, FILE* fp);
+
+#endif
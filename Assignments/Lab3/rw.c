@@ -4,6 +4,7 @@
  * Project: CSCI 3753 Programming Assignment 3
  * Create Date: 2012/03/19
  * Modify Date: 2012/03/20
+ * Modify Date: 2026/10/19
  * Description: A small i/o bound program to copy N bytes from an input
  *              file to an output file. May read the input file multiple
  *              times if N is larger than the size of the input file.
@@ -24,6 +25,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+
+/* Local Includes */
+#include "launch.h"
+#include "sched-policy.h"
+#include "rw-copy.h"
 
 /* Local Defines */
 #define MAXFILENAMELENGTH 80
@@ -32,7 +39,7 @@
 #define DEFAULT_BLOCKSIZE 1024
 #define DEFAULT_TRANSFERSIZE 1024*100
 
-#define USAGE "./cpu-bound ITERATIONS SCHED_POLICY PROC_COUNT\n"
+#define USAGE "./rw [-c] [-e read|copy_file_range|sendfile|splice|mmap|io_uring] [-q DEPTH] [-P] [-s] PROC_COUNT SCHED_POLICY TRANSFER_BYTES BLOCK_SIZE INPUT_FILE OUTPUT_BASE\n"
 #define DEFAULT_PROCESSES 5
 
 int main(int argc, char* argv[]){
@@ -44,25 +51,57 @@ int main(int argc, char* argv[]){
     char outputFilename[MAXFILENAMELENGTH];
     char outputFilenameBase[MAXFILENAMELENGTH];
     
-    struct sched_param param;
-    int policy;
+    policy_population policies;
     int numberOfProcesses;
-    int child_status;
 
     ssize_t transfersize = 0;
     ssize_t blocksize = 0; 
     char* transferBuffer = NULL;
     ssize_t buffersize;
 
-    ssize_t bytesRead = 0;
-    ssize_t totalBytesRead = 0;
-    int totalReads = 0;
-    ssize_t bytesWritten = 0;
-    ssize_t totalBytesWritten = 0;
-    int totalWrites = 0;
-    int inputFileResets = 0;
+    rwcopy copy;
+    int engine = RWCOPY_READ;
+    int queueDepth = RWCOPY_DEFAULT_DEPTH;
+    int sqpoll = 0;
+    int striped = 0;
+    struct stat inputStat;
+    off_t stripe = 0;
+    ssize_t blocks;
+    rwcopy_share* shares;
 
     int pid;
+    int opt;
+    int mode = LAUNCH_SEQUENTIAL; /* -c, start every child at once */
+    launch children;
+
+    /* -c forks every child before any starts, see launch.h,
+     * -e picks how the children copy, see rw-copy.h,
+     * -q and -P set the io_uring queue depth and SQPOLL,
+     * -s gives each child its own stripe of the input */
+    while((opt = getopt(argc, argv, "ce:q:Ps")) != -1){
+	if(opt == 'c'){
+	    mode = LAUNCH_CONCURRENT;
+	}
+	else if(opt == 'q' && (queueDepth = atoi(optarg)) > 0){
+	    continue;
+	}
+	else if(opt == 'P'){
+	    sqpoll = 1;
+	}
+	else if(opt == 's'){
+	    striped = 1;
+	}
+	else if(opt == 'e' && (engine = rwcopy_engine(optarg)) != RWCOPY_FAILURE){
+	    continue;
+	}
+	else{
+	    fprintf(stderr, USAGE);
+	    exit(EXIT_FAILURE);
+	}
+    }
+    /* the positional arguments follow as before */
+    argv += optind - 1;
+    argc -= optind - 1;
     
     
     if(argc < 2){
@@ -77,32 +116,15 @@ int main(int argc, char* argv[]){
         }
 	}
 
-    /* Set policy if supplied */
-    if(argc > 2){
-		if(!strcmp(argv[2], "SCHED_OTHER")){
-		    policy = SCHED_OTHER;
-		}
-		else if(!strcmp(argv[2], "SCHED_FIFO")){
-		    policy = SCHED_FIFO;
-		}
-		else if(!strcmp(argv[2], "SCHED_RR")){
-		    policy = SCHED_RR;
-		}
-		else{
-		    fprintf(stderr, "Unhandeled scheduling policy\n");
-		    exit(EXIT_FAILURE);
-		}
-    }   
-    
-    param.sched_priority = sched_get_priority_max(policy);
-    /* Set new scheduler policy */
-    fprintf(stdout, "Current Scheduling Policy: %d\n", sched_getscheduler(0));
-    fprintf(stdout, "Setting Scheduling Policy to: %d\n", policy);
-    if(sched_setscheduler(0, policy, &param)){
-	perror("Error setting scheduler policy");
+    /* Set policy, SCHED_OTHER if not supplied, see sched-policy.h */
+    if(policy_parse(&policies, argc > 2 ? argv[2] : "SCHED_OTHER") == POLICY_FAILURE){
+	exit(EXIT_FAILURE);
+    }
+    /* Each child sets its own class, fail here if we cannot */
+    policy_print(&policies, numberOfProcesses, stdout);
+    if(policy_check(&policies) == POLICY_FAILURE){
 	exit(EXIT_FAILURE);
     }
-    fprintf(stdout, "New Scheduling Policy: %d\n", sched_getscheduler(0));
     
     
     /* Process program arguments to select run-time parameters */
@@ -184,9 +206,36 @@ int main(int argc, char* argv[]){
 	exit(EXIT_FAILURE);
     }
     
+    /* Striped: child k copies its share of transfersize from stripe k
+     * of the input, whole blocks, no two children reading the same */
+    blocks = transfersize / blocksize;
+    if(striped){
+	if(fstat(inputFD, &inputStat)){
+	    perror("Failed to size input file");
+	    exit(EXIT_FAILURE);
+	}
+	stripe = inputStat.st_size / blocksize / numberOfProcesses * blocksize;
+	if(stripe < blocksize || blocks < numberOfProcesses){
+	    fprintf(stderr, "Input and transfersize need a block for every child\n");
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    /* the children leave what they copied here */
+    shares = mmap(NULL, numberOfProcesses * sizeof(*shares), PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(shares == MAP_FAILED){
+	perror("Failed to map shared results");
+	exit(EXIT_FAILURE);
+    }
+
+	if(launch_init(&children, mode, numberOfProcesses) == LAUNCH_FAILURE){
+	    exit(EXIT_FAILURE);
+	}
+	launch_child_setup(&children, policy_child_setup, &policies);
 	int k = 0; 
 	for (k = 0; k < numberOfProcesses; k++){
-		pid = fork();
+		pid = launch_fork(&children);
 		if (pid == 0){
 			/* Open Output File Descriptor in Write Only mode with standard permissions*/
 			rv = snprintf(outputFilename, MAXFILENAMELENGTH, "%s-%d",
@@ -202,7 +251,7 @@ int main(int argc, char* argv[]){
 			}
 			if((outputFD =
 			open(outputFilename,
-				 O_WRONLY | O_CREAT | O_TRUNC | O_SYNC,
+				 O_RDWR | O_CREAT | O_TRUNC | O_SYNC,
 				 S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH)) < 0){
 			perror("Failed to open output file");
 			exit(EXIT_FAILURE);
@@ -212,51 +261,34 @@ int main(int argc, char* argv[]){
 			fprintf(stdout, "Reading from %s and writing to %s\n",
 				inputFilename, outputFilename);
 
-			/* Read from input file and write to output file*/
-			do{
-			/* Read transfersize bytes from input file*/
-			bytesRead = read(inputFD, transferBuffer, buffersize);
-			if(bytesRead < 0){
-				perror("Error reading input file");
-				exit(EXIT_FAILURE);
-			}
-			else{
-				totalBytesRead += bytesRead;
-				totalReads++;
-			}
-
-			/* If all bytes were read, write to output file*/
-			if(bytesRead == blocksize){
-				bytesWritten = write(outputFD, transferBuffer, bytesRead);
-				if(bytesWritten < 0){
-				perror("Error writing output file");
-				exit(EXIT_FAILURE);
-				}
-				else{
-				totalBytesWritten += bytesWritten;
-				totalWrites++;
-				}
-			}
-			/* Otherwise assume we have reached the end of the input file and reset */
-			else{
-				if(lseek(inputFD, 0, SEEK_SET)){
-				perror("Error resetting to beginning of file");
-				exit(EXIT_FAILURE);
-				}
-				inputFileResets++;
+			/* Copy from input file to output file */
+			copy.engine = engine;
+			copy.inputFD = inputFD;
+			copy.inputOffset = striped ? k * stripe : 0;
+			copy.inputLength = stripe;
+			copy.outputFD = outputFD;
+			copy.transfersize = striped ?
+			    (blocks / numberOfProcesses + (k < blocks % numberOfProcesses)) * blocksize :
+			    transfersize;
+			copy.blocksize = blocksize;
+			copy.buffer = transferBuffer;
+			copy.queueDepth = queueDepth;
+			copy.sqpoll = sqpoll;
+			if(rwcopy_run(&copy) == RWCOPY_FAILURE){
+			exit(EXIT_FAILURE);
 			}
-
-			}while(totalBytesWritten < transfersize);
+			rwcopy_share_of(&copy, &shares[k]);
 
 			/* Output some possibly helpfull info to make it seem like we were doing stuff */
 			fprintf(stdout, "Read:    %zd bytes in %d reads\n",
-				totalBytesRead, totalReads);
+				copy.bytesRead, copy.reads);
 			fprintf(stdout, "Written: %zd bytes in %d writes\n",
-				totalBytesWritten, totalWrites);
+				copy.bytesWritten, copy.writes);
 			fprintf(stdout, "Read input file in %d pass%s\n",
-				(inputFileResets + 1), (inputFileResets ? "es" : ""));
+				(copy.passes + 1), (copy.passes ? "es" : ""));
 			fprintf(stdout, "Processed %zd bytes in blocks of %zd bytes\n",
-				transfersize, blocksize);
+				copy.transfersize, blocksize);
+			rwcopy_print(&copy, stdout);
 
 			/* Free Buffer */
 			free(transferBuffer);
@@ -275,13 +307,16 @@ int main(int argc, char* argv[]){
 			return 0;
 		}
 		else if (pid < 0){
-            fprintf(stderr, "Error creating child process");
             exit(EXIT_FAILURE);
         }
-        else {
-            wait(NULL);
-        }
 	}
+	/* with -c this is where they all start */
+	rv = launch_wait(&children) ? EXIT_FAILURE : EXIT_SUCCESS;
+	launch_report(&children, stdout);
+	policy_report(&policies, &children, stdout);
+	rwcopy_aggregate(shares, numberOfProcesses, stdout);
+	munmap(shares, numberOfProcesses * sizeof(*shares));
+	launch_cleanup(&children);
 
-    return EXIT_SUCCESS;
+    return rv;
 }
@@ -0,0 +1,284 @@
+/*
+ * File: sched-policy.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the parsing, setting and per class reporting
+ *      of the scheduling classes the workload children run under.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "sched-policy.h"
+#include "stats.h"
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+/* sched_setattr has no glibc wrapper, this is its first version */
+typedef struct policy_attr_s{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+} policy_attr;
+
+static const struct{
+    const char* name;
+    int policy;
+} policyNames[] = {
+    { "SCHED_OTHER", SCHED_OTHER },
+    { "SCHED_BATCH", SCHED_BATCH },
+    { "SCHED_IDLE", SCHED_IDLE },
+    { "SCHED_FIFO", SCHED_FIFO },
+    { "SCHED_RR", SCHED_RR },
+    { "SCHED_DEADLINE", SCHED_DEADLINE },
+};
+
+/* Parse a whole int, no trailing junk */
+static int parse_int(const char* s, int* value){
+    char* end;
+    long v;
+
+    errno = 0;
+    v = strtol(s, &end, 10);
+    if(errno || end == s || *end){
+	return POLICY_FAILURE;
+    }
+    *value = v;
+    return POLICY_SUCCESS;
+}
+
+static int parse_class(policy_class* c, const char* text){
+    unsigned long runtime, deadline, period;
+    const char* arg;
+    size_t nameLen;
+    size_t i;
+    int n;
+
+    if(strlen(text) >= POLICY_NAMELEN){
+	fprintf(stderr, "Scheduling class %s too long\n", text);
+	return POLICY_FAILURE;
+    }
+    strcpy(c->name, text);
+    arg = strchr(text, ':');
+    nameLen = arg ? (size_t)(arg - text) : strlen(text);
+    if(arg){
+	arg++;
+    }
+
+    c->policy = -1;
+    for(i=0; i<sizeof(policyNames)/sizeof(policyNames[0]); i++){
+	if(strlen(policyNames[i].name) == nameLen &&
+	   !strncmp(policyNames[i].name, text, nameLen)){
+	    c->policy = policyNames[i].policy;
+	}
+    }
+    c->priority = 0;
+    c->nice = 0;
+    c->hasNice = 0;
+    c->runtime = c->deadline = c->period = 0;
+
+    switch(c->policy){
+    case SCHED_OTHER:
+    case SCHED_BATCH:
+    case SCHED_IDLE:
+	if(arg){
+	    if(parse_int(arg, &c->nice) || c->nice < -20 || c->nice > 19){
+		fprintf(stderr, "Bad nice value in %s, -20 to 19\n", text);
+		return POLICY_FAILURE;
+	    }
+	    c->hasNice = 1;
+	}
+	return POLICY_SUCCESS;
+    case SCHED_FIFO:
+    case SCHED_RR:
+	c->priority = sched_get_priority_max(c->policy);
+	if(arg && (parse_int(arg, &c->priority) ||
+		   c->priority < sched_get_priority_min(c->policy) ||
+		   c->priority > sched_get_priority_max(c->policy))){
+	    fprintf(stderr, "Bad priority in %s, %d to %d\n", text,
+		    sched_get_priority_min(c->policy), sched_get_priority_max(c->policy));
+	    return POLICY_FAILURE;
+	}
+	return POLICY_SUCCESS;
+    case SCHED_DEADLINE:
+	n = arg ? sscanf(arg, "%lu/%lu/%lu", &runtime, &deadline, &period) : 0;
+	if(n < 2){
+	    fprintf(stderr, "%s needs runtime/deadline[/period] in microseconds\n", text);
+	    return POLICY_FAILURE;
+	}
+	if(n == 2){
+	    period = deadline;
+	}
+	if(runtime < 1 || runtime > deadline || deadline > period){
+	    fprintf(stderr, "%s needs runtime <= deadline <= period\n", text);
+	    return POLICY_FAILURE;
+	}
+	c->runtime = runtime * 1000;
+	c->deadline = deadline * 1000;
+	c->period = period * 1000;
+	return POLICY_SUCCESS;
+    }
+    fprintf(stderr, "Unhandeled scheduling policy\n");
+    return POLICY_FAILURE;
+}
+
+int policy_parse(policy_population* p, const char* spec){
+    char text[POLICY_MAXCLASSES * POLICY_NAMELEN];
+    char* save;
+    char* item;
+
+    if(strlen(spec) >= sizeof(text)){
+	fprintf(stderr, "Scheduling policy too long\n");
+	return POLICY_FAILURE;
+    }
+    strcpy(text, spec);
+    p->nclasses = 0;
+    for(item=strtok_r(text, "+", &save); item; item=strtok_r(NULL, "+", &save)){
+	if(p->nclasses == POLICY_MAXCLASSES){
+	    fprintf(stderr, "More than %d scheduling classes\n", POLICY_MAXCLASSES);
+	    return POLICY_FAILURE;
+	}
+	if(parse_class(&p->classes[p->nclasses++], item) == POLICY_FAILURE){
+	    return POLICY_FAILURE;
+	}
+    }
+    if(p->nclasses == 0){
+	fprintf(stderr, "Unhandeled scheduling policy\n");
+	return POLICY_FAILURE;
+    }
+    return POLICY_SUCCESS;
+}
+
+const policy_class* policy_class_of(const policy_population* p, int index){
+    return &p->classes[index % p->nclasses];
+}
+
+int policy_apply(const policy_class* c){
+    struct sched_param param;
+    policy_attr attr;
+
+    if(c->policy == SCHED_DEADLINE){
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.sched_policy = SCHED_DEADLINE;
+	attr.sched_runtime = c->runtime;
+	attr.sched_deadline = c->deadline;
+	attr.sched_period = c->period;
+	if(syscall(SYS_sched_setattr, 0, &attr, 0)){
+	    perror("Error setting SCHED_DEADLINE");
+	    return POLICY_FAILURE;
+	}
+	return POLICY_SUCCESS;
+    }
+
+    param.sched_priority = c->priority;
+    if(sched_setscheduler(0, c->policy, &param)){
+	perror("Error setting scheduler policy");
+	return POLICY_FAILURE;
+    }
+    if(c->hasNice && setpriority(PRIO_PROCESS, 0, c->nice)){
+	perror("Error setting nice value");
+	return POLICY_FAILURE;
+    }
+    return POLICY_SUCCESS;
+}
+
+int policy_check(const policy_population* p){
+    int status;
+    pid_t pid;
+    int i;
+
+    for(i=0; i<p->nclasses; i++){
+	fflush(NULL);
+	pid = fork();
+	if(pid < 0){
+	    perror("Error creating process");
+	    return POLICY_FAILURE;
+	}
+	if(pid == 0){
+	    _exit(policy_apply(&p->classes[i]) == POLICY_SUCCESS ? 0 : 1);
+	}
+	if(waitpid(pid, &status, 0) != pid ||
+	   !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+	    fprintf(stderr, "Cannot run children as %s\n", p->classes[i].name);
+	    return POLICY_FAILURE;
+	}
+    }
+    return POLICY_SUCCESS;
+}
+
+int policy_child_setup(int index, void* arg){
+    return policy_apply(policy_class_of(arg, index));
+}
+
+void policy_print(const policy_population* p, int nchildren, FILE* fp){
+    int i;
+
+    fprintf(fp, "Scheduling:");
+    for(i=0; i<p->nclasses; i++){
+	fprintf(fp, "%s %s x%d", i ? "," : "", p->classes[i].name,
+		nchildren / p->nclasses + (i < nchildren % p->nclasses));
+    }
+    fprintf(fp, "\n");
+}
+
+void policy_report(const policy_population* p, const launch* l, FILE* fp){
+    double* turnaround;
+    double* firstRun;
+    double* rate;
+    stats t;
+    stats f;
+    int c;
+    int i;
+    int n;
+
+    if(p->nclasses < 2){
+	return;
+    }
+    turnaround = malloc(l->started * sizeof(double) + 1);
+    firstRun = malloc(l->started * sizeof(double) + 1);
+    rate = malloc(l->started * sizeof(double) + 1);
+    if(!turnaround || !firstRun || !rate){
+	perror("Failed to allocate report");
+	free(turnaround);
+	free(firstRun);
+	free(rate);
+	return;
+    }
+    for(c=0; c<p->nclasses; c++){
+	n = 0;
+	for(i=c; i<l->started; i+=p->nclasses){
+	    launch_child_times(l, i, &firstRun[n], &turnaround[n]);
+	    rate[n] = turnaround[n] > 0 ? 1.0 / turnaround[n] : 0;
+	    n++;
+	}
+	stats_compute(turnaround, n, &t);
+	stats_compute(firstRun, n, &f);
+	fprintf(fp, "class: policy=%s children=%d turnaround_mean=%.6f "
+		"turnaround_max=%.6f first_run_mean=%.6f jain=%.4f\n",
+		p->classes[c].name, n, t.mean, t.max, f.mean, stats_jain(rate, n));
+    }
+    free(turnaround);
+    free(firstRun);
+    free(rate);
+}
@@ -0,0 +1,86 @@
+/*
+ * File: sched-policy.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the scheduling classes the children
+ *      of pi-sched, rw and mixed run under. The SCHED_POLICY argument
+ *      is one class or several joined with '+':
+ *
+ *      SCHED_OTHER[:nice]  SCHED_BATCH[:nice]  SCHED_IDLE[:nice]
+ *      SCHED_FIFO[:priority]  SCHED_RR[:priority]
+ *      SCHED_DEADLINE:runtime/deadline[/period]   (microseconds)
+ *
+ *      Without a nice value the nice of the parent is kept, without a
+ *      priority it is sched_get_priority_max, as before. The period
+ *      defaults to the deadline. Child k gets class k % classes, so
+ *      "SCHED_OTHER+SCHED_OTHER:10" puts every other child at nice 10
+ *      and "SCHED_RR+SCHED_BATCH+SCHED_BATCH" makes a third of them
+ *      real time. Each child sets its own class before it starts.
+ *      Negative nice, FIFO, RR and DEADLINE need root.
+ *
+ */
+
+#ifndef SCHED_POLICY_H
+#define SCHED_POLICY_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "launch.h"
+
+#define POLICY_FAILURE -1
+#define POLICY_SUCCESS 0
+
+#define POLICY_MAXCLASSES 16
+#define POLICY_NAMELEN 64
+
+typedef struct policy_class_s{
+    char name[POLICY_NAMELEN];  /* as given, for the report */
+    int policy;                 /* SCHED_* */
+    int priority;               /* FIFO and RR */
+    int nice;
+    int hasNice;                /* 0: leave nice alone */
+    uint64_t runtime;           /* DEADLINE, nanoseconds */
+    uint64_t deadline;
+    uint64_t period;
+} policy_class;
+
+typedef struct policy_population_s{
+    policy_class classes[POLICY_MAXCLASSES];
+    int nclasses;
+} policy_population;
+
+/* Function to parse a SCHED_POLICY argument
+ * Returns POLICY_SUCCESS or POLICY_FAILURE, with a message on stderr
+ */
+int policy_parse(policy_population* p, const char* spec);
+
+/* Function to find the class of child index */
+const policy_class* policy_class_of(const policy_population* p, int index);
+
+/* Function to put the calling process in class c
+ * Returns POLICY_SUCCESS or POLICY_FAILURE, with perror
+ */
+int policy_apply(const policy_class* c);
+
+/* Function to try every class in a throwaway child first, so a run
+ * without the privileges fails once and early instead of in every
+ * child it forks
+ * Returns POLICY_SUCCESS or POLICY_FAILURE
+ */
+int policy_check(const policy_population* p);
+
+/* launch_child_setup hook, arg is the policy_population */
+int policy_child_setup(int index, void* arg);
+
+/* Function to print which classes the nchildren get */
+void policy_print(const policy_population* p, int nchildren, FILE* fp);
+
+/* Function to print one line per class after launch_report, when
+ * there is more than one: "class: policy=NAME children=N
+ * turnaround_mean=S turnaround_max=S first_run_mean=S jain=J" */
+void policy_report(const policy_population* p, const launch* l, FILE* fp);
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * File: stats.c
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This file contains the summary statistics for the benchmark
+ *      driver and the launchers.
+ *
+ */
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "stats.h"
+
+/* two sided 95% t values for 1 to 30 degrees of freedom */
+static const double tTable[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t95(int df){
+    if(df <= 30){
+	return tTable[df - 1];
+    }
+    if(df <= 60){
+	return 2.000;
+    }
+    if(df <= 120){
+	return 1.980;
+    }
+    return 1.960;
+}
+
+void stats_compute(const double* values, int n, stats* s){
+    double sum = 0;
+    double sq = 0;
+    int i;
+
+    s->n = n;
+    s->mean = s->stddev = s->ci95 = s->min = s->max = 0;
+    if(n < 1){
+	return;
+    }
+    s->min = s->max = values[0];
+    for(i=0; i<n; i++){
+	sum += values[i];
+	if(values[i] < s->min){
+	    s->min = values[i];
+	}
+	if(values[i] > s->max){
+	    s->max = values[i];
+	}
+    }
+    s->mean = sum / n;
+    if(n < 2){
+	return;
+    }
+    for(i=0; i<n; i++){
+	sq += (values[i] - s->mean) * (values[i] - s->mean);
+    }
+    s->stddev = sqrt(sq / (n - 1));
+    s->ci95 = t95(n - 1) * s->stddev / sqrt(n);
+}
+
+static int compare_doubles(const void* a, const void* b){
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+void stats_sort(double* values, int n){
+    qsort(values, n, sizeof(*values), compare_doubles);
+}
+
+double stats_percentile(const double* sorted, int n, double p){
+    double rank;
+    int lo;
+
+    if(n < 1){
+	return 0;
+    }
+    rank = p / 100.0 * (n - 1);
+    lo = (int)rank;
+    if(lo >= n - 1){
+	return sorted[n - 1];
+    }
+    return sorted[lo] + (rank - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+double stats_jain(const double* values, int n){
+    double sum = 0;
+    double sq = 0;
+    int i;
+
+    for(i=0; i<n; i++){
+	sum += values[i];
+	sq += values[i] * values[i];
+    }
+    if(n < 1 || sq == 0){
+	return 0;
+    }
+    return sum * sum / (n * sq);
+}
@@ -0,0 +1,41 @@
+/*
+ * File: stats.h
+ * Author: Josh Fermin and Louis Bouddhou
+ * Project: CSCI 3753 Programming Assignment 3
+ * Create Date: 2026/10/19
+ * Description:
+ * 	This is the header file for the summary statistics the
+ *      benchmark driver reports for repeated runs, and the launchers
+ *      report for the children of one run.
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+typedef struct stats_s{
+    int n;
+    double mean;
+    double stddev;              /* sample standard deviation */
+    double ci95;                /* half width of the 95% interval */
+    double min;
+    double max;
+} stats;
+
+/* Function to summarize n values. The confidence interval uses
+ * Student's t for n - 1 degrees of freedom, it is 0 for n < 2. */
+void stats_compute(const double* values, int n, stats* s);
+
+/* Function to sort values in place, for stats_percentile */
+void stats_sort(double* values, int n);
+
+/* Function to find the p-th percentile (0 to 100) of n sorted values,
+ * interpolating between the two nearest ranks */
+double stats_percentile(const double* sorted, int n, double p);
+
+/* Function to compute Jain's fairness index of n values,
+ * (sum x)^2 / (n * sum x^2): 1 when all are equal, 1/n when one
+ * value has everything */
+double stats_jain(const double* values, int n);
+
+#endif